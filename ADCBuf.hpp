@@ -30,17 +30,26 @@
 #include <time.h>
 #include <memory>
 #include <vector>
-#include <fftw3.h>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <FFTWTraits.hpp>
 
 #include <IntrusiveShpFreeList.hpp>
 #include <IntrusiveShp.hpp>
 #include <AcqCtrl.hpp>
 #include <ScopeParams.hpp>
+#include <DSPKernels.hpp>
+#include <BufArena.hpp>
+#include <BufPool.hpp>
+#include <MinMaxLOD.hpp>
 
 class AcqSettings {
 	unsigned            sync_{0};     // count/flag that can be used to sync parameter changes across fifo domains
 	ScopeParamsCPtr     scopeParams_;
 	double              refScaleVolt_;
+	uint32_t            chnlMsk_{~0U};// channels the user wants to see
+	bool                fftEna_{true};// FFT is displayed
 
 public:
 
@@ -69,24 +78,11 @@ public:
 		return refScaleVolt_;
 	}
 
-	void
-	prepareForSerialization() const
-	{
-   	    // terrible hack to increment the reference
-        // count of the shared-pointer embedded in cmd
-        char mem[sizeof(scopeParams_)];
-        // placement new takes a reference but the
-        // so created Shp is never destroyed
-        // (but 'serialized' into the pipe)
-        new(static_cast<void*>(mem)) ScopeParamsCPtr(scopeParams_);
-	}
-
 	void
 	resetShp()
 	{
-  	    // release SHP since it will be
-        // 'hard-overwritten'
-        scopeParams_.reset();
+		// drop our reference to the parameters
+		scopeParams_.reset();
 	}
 
 	void
@@ -113,6 +109,50 @@ public:
 		return sync_;
 	}
 
+	bool
+	channelEnabled(unsigned ch) const
+	{
+		return !! ( chnlMsk_ & (1U << ch) );
+	}
+
+	void
+	setChannelEnabled(unsigned ch, bool on)
+	{
+		if ( on ) {
+			chnlMsk_ |=  (1U << ch);
+		} else {
+			chnlMsk_ &= ~(1U << ch);
+		}
+	}
+
+	// disabled channels are not processed - except for the
+	// trigger source which is needed for trigger interpolation
+	bool
+	channelProcessed(unsigned ch) const
+	{
+		if ( channelEnabled( ch ) ) {
+			return true;
+		}
+		switch ( scopeParams()->acqParams.src ) {
+			case CHA: return 0 == ch;
+			case CHB: return 1 == ch;
+			default:  break;
+		}
+		return false;
+	}
+
+	bool
+	fftEnabled() const
+	{
+		return fftEna_;
+	}
+
+	void
+	setFFTEnabled(bool on)
+	{
+		fftEna_ = on;
+	}
+
 	void
 	incrementSync()
 	{
@@ -120,26 +160,45 @@ public:
 	}
 };
 
-template <typename T, size_t NCH> class ADCBufPool;
+template <typename T> class ADCBufPool;
 
-template <typename T, size_t NCH = 2>
+// The number of channels is a run-time property (set by the pool);
+// only the (small) per-channel bookkeeping is dimensioned for
+// MAX_CHANNELS, sample arrays are allocated for the actual channels.
+template <typename T>
 class ADCBuf : public IntrusiveSmart::FreeListNode, public AcqSettings {
 	typedef IntrusiveSmart::Shp<ADCBuf>  ADCBufPtr;
+public:
+	// T is double or float; time-domain, FFT and modulus arrays
+	// all use T.
+	typedef FFTWTraits<T>              FFTW;
+	typedef typename FFTW::Complex     ComplexType;
+
+	constexpr static unsigned MAX_CHANNELS = 4;
 private:
-	unsigned               stride_;     // elements in buffer: stride_*NCH
+	ADCBufPool<T>         *pool_;       // notified when returned
+	unsigned               nch_;        // number of channels
+	unsigned               stride_;     // elements in buffer: stride_*nch_
 	unsigned               nelms_;      // # valid elements (per channel)
 	unsigned               hdr_;        // header received from ADC
-	double                 avg_[NCH];   // measurement (avg)
-	double                 std_[NCH];   // measurement (std-dev)
-	bool                   mVld_[NCH];  // measurement valid flag
+	double                 avg_[MAX_CHANNELS];   // measurement (avg)
+	double                 std_[MAX_CHANNELS];   // measurement (std-dev)
+	int32_t                rawMin_[MAX_CHANNELS];// measurement (min. raw ADC value)
+	int32_t                rawMax_[MAX_CHANNELS];// measurement (max. raw ADC value)
+	bool                   mVld_[MAX_CHANNELS];  // samples + measurement valid flag
+	bool                   fftVld_[MAX_CHANNELS];// FFT valid flag
+	bool                   lodVld_[MAX_CHANNELS];// min/max pyramid valid flag
 	time_t                 time_;
+	// all arrays live in a single arena
+	std::unique_ptr<BufArena> arena_;
 	uint8_t               *rawData_;
 	size_t                 rawSize_;
 	struct {
 	T                      *tdom;
-	fftw_complex           *fft;
-	double                 *fftM;
-	}                      data_[NCH];
+	ComplexType            *fft;
+	T                      *fftM;
+	T                      *lod;
+	}                      data_[MAX_CHANNELS];
 
 	ADCBuf(const ADCBuf &)    = delete;
 
@@ -150,25 +209,37 @@ public:
 
 	typedef T                  ElementType;
 
-	ADCBuf(unsigned stride, size_t rawElSz)
-	: stride_    ( stride )
+	// 'arenaFlags' are passed to BufArena
+	ADCBuf(unsigned nch, unsigned stride, size_t rawElSz, unsigned arenaFlags = 0, ADCBufPool<T> *pool = nullptr)
+	: pool_      ( pool   ),
+	  nch_       ( nch    ),
+	  stride_    ( stride )
 	{
+		if ( 0 == nch || nch > MAX_CHANNELS ) {
+			throw std::invalid_argument( "ADCBuf: unsupported number of channels" );
+		}
 		invalidate();
-		allocData(rawElSz);
+		allocData(rawElSz, arenaFlags);
 	}
 
 	void
 	invalidate()
 	{
-		for (int i = 0; i < NCH; i++ ) {
-			mVld_ [i] = false;
+		for (int i = 0; i < MAX_CHANNELS; i++ ) {
+			mVld_  [i] = false;
+			fftVld_[i] = false;
+			lodVld_[i] = false;
 		}
 		resetShp();
 	}
 
-	virtual void unmanage(const Key &k) override {
-		IntrusiveSmart::FreeListNode::unmanage( k );
-		invalidate();
+	virtual void unmanage(const Key &k) override;
+
+	// bytes of sample memory
+	size_t
+	getMemSize() const
+	{
+		return arena_->size();
 	}
 
 	~ADCBuf()
@@ -197,13 +268,13 @@ public:
 	unsigned
 	getNumChannels() const
 	{
-		return NCH;
+		return nch_;
 	}
 
 	unsigned
 	getSize() const
 	{
-		return stride_ * NCH;
+		return stride_ * nch_;
 	}
 
 	unsigned
@@ -279,16 +350,36 @@ public:
 		setTime( time( nullptr ) );
 	}
 
+	// derive measurements from statistics of the raw samples
+	// (computed while de-interleaving); this also marks the
+	// samples of 'ch' valid.
 	void
-	measure();
+	setRawStats(unsigned ch, const DSPKernels::RawStats &st);
 
-	void
-	measure(unsigned ch);
+	// channels which were skipped by the reader (see
+	// AcqSettings::channelProcessed()) hold stale data
+	bool
+	dataValid(unsigned ch) const
+	{
+		return ch < nch_ && mVld_[ch];
+	}
+
+	bool
+	fftValid(unsigned ch) const
+	{
+		return ch < nch_ && fftVld_[ch];
+	}
+
+	bool
+	lodValid(unsigned ch) const
+	{
+		return ch < nch_ && lodVld_[ch];
+	}
 
 	double
 	getAvg(unsigned ch)
 	{
-		if ( ch >= NCH ) {
+		if ( ch >= nch_ ) {
 			throw std::invalid_argument( __func__ );
 		}
 		if ( ! mVld_[ch] ) {
@@ -300,7 +391,7 @@ public:
 	double
 	getStd(unsigned ch)
 	{
-		if ( ch >= NCH ) {
+		if ( ch >= nch_ ) {
 			throw std::invalid_argument( __func__ );
 		}
 		if ( ! mVld_[ch] ) {
@@ -309,11 +400,35 @@ public:
 		return std_[ch];
 	}
 
+	int32_t
+	getRawMin(unsigned ch)
+	{
+		if ( ch >= nch_ ) {
+			throw std::invalid_argument( __func__ );
+		}
+		if ( ! mVld_[ch] ) {
+			throw std::runtime_error( "measurements not available" );
+		}
+		return rawMin_[ch];
+	}
+
+	int32_t
+	getRawMax(unsigned ch)
+	{
+		if ( ch >= nch_ ) {
+			throw std::invalid_argument( __func__ );
+		}
+		if ( ! mVld_[ch] ) {
+			throw std::runtime_error( "measurements not available" );
+		}
+		return rawMax_[ch];
+	}
+
 
 	T *
 	getData(unsigned ch)
 	{
-		if ( ch < NCH ) {
+		if ( ch < nch_ ) {
 			return data_[ ch ].tdom;
 		}
 		throw std::invalid_argument( __func__ );
@@ -331,89 +446,213 @@ public:
 		return rawSize_;
 	}
 
-	fftw_complex *
+	ComplexType *
 	getFFT(unsigned ch)
 	{
-		if ( ch < NCH ) {
+		if ( ch < nch_ ) {
 			return data_[ ch ].fft;
 		}
 		throw std::invalid_argument( __func__ );
 	}
 
-	double *
+	T *
 	getFFTModulus(unsigned ch)
 	{
-		if ( ch < NCH ) {
+		if ( ch < nch_ ) {
 			return data_[ ch ].fftM;
 		}
 		throw std::invalid_argument( __func__ );
 	}
 
+	// build the min/max pyramid of the time-domain samples
+	// (for drawing long records at screen resolution)
 	void
-	computeAbsFFT(unsigned ch)
+	computeLOD(unsigned ch)
+	{
+		MinMaxLOD<T>::build( getData( ch ), nelms_, data_[ch].lod );
+		lodVld_[ch] = true;
+	}
+
+	MinMaxLOD<T>
+	getLOD(unsigned ch)
 	{
-		fftw_complex *sp = getFFT( ch );
-		double       *dp = getFFTModulus( ch );
-		double       scl = (double)nelms_/32768.0;
-		for ( size_t i = 0; i < nelms_/2 + 1; ++i ) {
-			dp[i] = log10(hypot( sp[i][0], sp[i][1] ));
+		if ( ! lodValid( ch ) ) {
+			throw std::runtime_error( "min/max pyramid not available" );
 		}
+		return MinMaxLOD<T>( data_[ch].tdom, data_[ch].lod, nelms_ );
+	}
+
+	// 'fast' selects an approximation of the logarithm
+	// (DSPKernels::logModulus)
+	void
+	computeAbsFFT(unsigned ch, bool fast = false)
+	{
+		ComplexType  *sp = getFFT( ch );
+		T            *dp = getFFTModulus( ch );
+		DSPKernels::logModulus( sp, nelms_/2 + 1, dp, fast );
 		// one-sided spectrum;
 		dp[0] -= log10(2.0)/2.0;
+		fftVld_[ch] = true;
 	}
 
 	void
-	allocData(size_t rawElSz)
-	{
-		for ( int i = 0; i < NCH; ++i ) {
-			data_[i].tdom = fftw_alloc_real( stride_ );
-			data_[i].fft  = fftw_alloc_complex( stride_/2 + 1 );
-			data_[i].fftM = new double[ stride_/2 + 1 ];
-			if ( ! data_[i].tdom || ! data_[i].fft || ! data_[i].fftM ) {
-				throw std::runtime_error("no memory");
-			}
-		}
-		rawSize_ = rawElSz*NCH*stride_;
-		rawData_ = static_cast<uint8_t*>( ::malloc( rawSize_ ) );
-		if ( ! rawData_ ) {
-			throw std::runtime_error("no memory");
+	allocData(size_t rawElSz, unsigned arenaFlags = 0)
+	{
+		size_t tdomSz = BufArena::align( sizeof(T)           * stride_         );
+		size_t fftSz  = BufArena::align( sizeof(ComplexType) * (stride_/2 + 1) );
+		size_t fftMSz = BufArena::align( sizeof(T)           * (stride_/2 + 1) );
+		size_t lodSz  = BufArena::align( sizeof(T)           * MinMaxLOD<T>::storage( stride_ ) );
+
+		rawSize_ = rawElSz*nch_*stride_;
+
+		arena_.reset( new BufArena( BufArena::align( rawSize_ ) + nch_ * ( tdomSz + fftSz + fftMSz + lodSz ), arenaFlags ) );
+
+		uint8_t *p = static_cast<uint8_t*>( arena_->data() );
+		rawData_   = p;
+		p         += BufArena::align( rawSize_ );
+		for ( int i = 0; i < nch_; ++i ) {
+			data_[i].tdom = reinterpret_cast<T*>( p );
+			p            += tdomSz;
+			data_[i].fft  = reinterpret_cast<ComplexType*>( p );
+			p            += fftSz;
+			data_[i].fftM = reinterpret_cast<T*>( p );
+			p            += fftMSz;
+			data_[i].lod  = reinterpret_cast<T*>( p );
+			p            += lodSz;
 		}
 	}
 
 	void
 	freeData()
 	{
-		for ( int i = 0; i < NCH; ++i ) {
-			fftw_free( data_[i].tdom );
+		for ( int i = 0; i < MAX_CHANNELS; ++i ) {
 			data_[i].tdom = nullptr;
-			fftw_free( data_[i].fft );
 			data_[i].fft  = nullptr;
-			delete [] data_[i].fftM;
 			data_[i].fftM = nullptr;
+			data_[i].lod  = nullptr;
 		}
-		::free( rawData_ );
 		rawData_ = nullptr;
+		arena_.reset();
 	}
 };
 
-template <typename T, size_t NCH = 2>
+// What ADCBufPool::get() does if all buffers are in use
+enum class ADCBufPoolPolicy {
+	FAIL,        // throw std::bad_alloc
+	BLOCK,       // wait (with timeout) for a buffer to be returned
+	GROW,        // add buffers up to a memory budget
+	DROP_OLDEST  // let the owner reclaim its oldest buffer (see setReclaim())
+};
+
+struct ADCBufPoolStats {
+	unsigned    bufs       {0}; // buffers in the pool
+	unsigned    inUse      {0}; // buffers currently handed out
+	unsigned    highWater  {0}; // max. buffers handed out at any time
+	size_t      bytes      {0}; // sample memory of all buffers
+	uint64_t    gets       {0}; // successful get() calls
+	uint64_t    exhausted  {0}; // get() found the pool empty
+	uint64_t    grown      {0}; // buffers added by the GROW policy
+	uint64_t    reclaimed  {0}; // buffers reclaimed by the DROP_OLDEST policy
+	uint64_t    timeouts   {0}; // BLOCK policy timed out
+};
+
+template <typename T>
 class ADCBufPool : public IntrusiveSmart::FreeListBase {
+public:
+	typedef ADCBuf<T>                       ADCBufType;
+	typedef IntrusiveSmart::Shp<ADCBufType> ADCBufPtr;
+	typedef ADCBufPoolPolicy                Policy;
+
 private:
+	unsigned                      nch_;
 	unsigned                      maxNElms_;
 	size_t                        rawElSz_;
+	unsigned                      arenaFlags_ {0};
+	Policy                        policy_     {Policy::FAIL};
+	unsigned                      timeoutMs_  {0};
+	size_t                        budget_     {0};
+	std::function<bool()>         reclaim_;
+	std::mutex                    growMtx_;
+	FutexEvent                    returned_;
+
+	std::atomic<unsigned>         bufs_       {0};
+	std::atomic<unsigned>         inUse_      {0};
+	std::atomic<unsigned>         highWater_  {0};
+	std::atomic<size_t>           bytes_      {0};
+	std::atomic<uint64_t>         gets_       {0};
+	std::atomic<uint64_t>         exhausted_  {0};
+	std::atomic<uint64_t>         grown_      {0};
+	std::atomic<uint64_t>         reclaimed_  {0};
+	std::atomic<uint64_t>         timeouts_   {0};
 
-public:
+	ADCBufPtr
+	tryGet()
+	{
+		auto rv = FreeListBase::get<typename ADCBufPtr::element_type>();
+		if ( rv ) {
+			gets_++;
+			unsigned n = ++inUse_;
+			unsigned h = highWater_.load( std::memory_order_relaxed );
+			while ( n > h && ! highWater_.compare_exchange_weak( h, n ) )
+				;
+		}
+		return rv;
+	}
 
-	const static unsigned         NumChannels = NCH;
+	// returns false if the budget is exhausted
+	bool
+	grow()
+	{
+		std::lock_guard<std::mutex> g( growMtx_ );
+		size_t bufSz = bufs_.load() ? bytes_.load()/bufs_.load() : 0;
+		if ( bytes_.load() + bufSz > budget_ ) {
+			return false;
+		}
+		add( 1 );
+		grown_++;
+		return true;
+	}
 
-	ADCBufPool(unsigned maxNElms, size_t rawElSz_)
-	: maxNElms_( maxNElms ),
+	// returns false on timeout
+	bool
+	waitReturned(const struct timespec &deadline)
+	{
+		struct timespec now, timo;
+		uint32_t        key = returned_.prepareWait();
+		// a buffer may have been returned meanwhile
+		if ( inUse_.load() < bufs_.load() ) {
+			returned_.cancelWait();
+			return true;
+		}
+		clock_gettime( CLOCK_MONOTONIC, &now );
+		timo.tv_sec  = deadline.tv_sec  - now.tv_sec;
+		timo.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+		if ( timo.tv_nsec < 0 ) {
+			timo.tv_nsec += 1000000000L;
+			timo.tv_sec--;
+		}
+		if ( timo.tv_sec < 0 ) {
+			returned_.cancelWait();
+			return false;
+		}
+		returned_.wait( key, &timo );
+		return true;
+	}
+
+public:
+
+	ADCBufPool(unsigned nch, unsigned maxNElms, size_t rawElSz_)
+	: nch_     ( nch      ),
+	  maxNElms_( maxNElms ),
 	  rawElSz_ ( rawElSz_ )
 	{
 	}
 
-	typedef ADCBuf<T,NCH>                   ADCBufType;
-	typedef IntrusiveSmart::Shp<ADCBufType> ADCBufPtr;
+	unsigned
+	getNumChannels() const
+	{
+		return nch_;
+	}
 
 	unsigned
 	getMaxNElms()
@@ -427,57 +666,157 @@ public:
 		return rawElSz_;
 	}
 
+	// BufArena flags for buffers added subsequently
+	void
+	setArenaFlags(unsigned flags)
+	{
+		arenaFlags_ = flags;
+	}
+
+	unsigned
+	getArenaFlags() const
+	{
+		return arenaFlags_;
+	}
+
+	// 'timeoutMs' is used by the BLOCK policy, 'budget' (bytes of
+	// sample memory) by the GROW policy.
+	void
+	setPolicy(Policy policy, unsigned timeoutMs = 0, size_t budget = 0)
+	{
+		policy_    = policy;
+		timeoutMs_ = timeoutMs;
+		budget_    = budget;
+	}
+
+	Policy
+	getPolicy() const
+	{
+		return policy_;
+	}
+
+	// DROP_OLDEST policy: called when the pool is empty; shall
+	// release the oldest buffer the owner holds (returning true)
+	// or return false if there is none.
+	void
+	setReclaim(std::function<bool()> reclaim)
+	{
+		reclaim_ = reclaim;
+	}
+
 	void
 	add(size_t poolDepth)
 	{
 		while ( poolDepth-- ) {
-			put( new ADCBufType( getMaxNElms(), getRawElSz() ) );
+			auto b = new ADCBufType( getNumChannels(), getMaxNElms(), getRawElSz(), getArenaFlags(), this );
+			bytes_ += b->getMemSize();
+			bufs_++;
+			put( b );
 		}
 	}
 
+	// throws std::bad_alloc if no buffer can be obtained
+	// according to the policy.
 	ADCBufPtr
 	get()
 	{
-		auto rv = FreeListBase::get<typename ADCBufPtr::element_type>();
-		if ( ! rv ) {
-			// out of buffers
-			throw std::bad_alloc();
+		ADCBufPtr       rv;
+		struct timespec deadline;
+
+		if ( (rv = tryGet()) ) {
+			return rv;
+		}
+		exhausted_++;
+		if ( Policy::BLOCK == policy_ ) {
+			clock_gettime( CLOCK_MONOTONIC, &deadline );
+			deadline.tv_sec  += timeoutMs_ / 1000;
+			deadline.tv_nsec += (timeoutMs_ % 1000) * 1000000L;
+			if ( deadline.tv_nsec >= 1000000000L ) {
+				deadline.tv_nsec -= 1000000000L;
+				deadline.tv_sec++;
+			}
+		}
+		while ( ! (rv = tryGet()) ) {
+			switch ( policy_ ) {
+				case Policy::BLOCK:
+					if ( ! waitReturned( deadline ) ) {
+						timeouts_++;
+						throw std::bad_alloc();
+					}
+					break;
+				case Policy::GROW:
+					if ( ! grow() ) {
+						throw std::bad_alloc();
+					}
+					break;
+				case Policy::DROP_OLDEST:
+					if ( ! reclaim_ || ! reclaim_() ) {
+						throw std::bad_alloc();
+					}
+					reclaimed_++;
+					break;
+				default:
+					// out of buffers
+					throw std::bad_alloc();
+			}
 		}
 		return rv;
 	}
+
+	// called by ADCBuf when it is returned to the pool
+	void
+	bufReturned()
+	{
+		inUse_--;
+		returned_.notify();
+	}
+
+	ADCBufPoolStats
+	getStats() const
+	{
+		ADCBufPoolStats st;
+		st.bufs      = bufs_.load();
+		st.inUse     = inUse_.load();
+		st.highWater = highWater_.load();
+		st.bytes     = bytes_.load();
+		st.gets      = gets_.load();
+		st.exhausted = exhausted_.load();
+		st.grown     = grown_.load();
+		st.reclaimed = reclaimed_.load();
+		st.timeouts  = timeouts_.load();
+		return st;
+	}
 };
 
-template <typename T, size_t NCH>
+template <typename T>
 void
-ADCBuf<T, NCH>::measure()
+ADCBuf<T>::unmanage(const Key &k)
 {
-	for ( int ch = 0; ch < NCH; ch++ ) {
-		measure( ch );
+	IntrusiveSmart::FreeListNode::unmanage( k );
+	invalidate();
+	if ( pool_ ) {
+		pool_->bufReturned();
 	}
 }
 
-template <typename T, size_t NCH>
+template <typename T>
 void
-ADCBuf<T, NCH>::measure(unsigned ch)
+ADCBuf<T>::setRawStats(unsigned ch, const DSPKernels::RawStats &st)
 {
-	double y;
-	T     *p;
-
-	y = 0.0;
-	p = getData( ch );
-
-	for ( int i = 0; i < nelms_; i++ ) {
-		y += *p++;
+	if ( ch >= nch_ ) {
+		throw std::invalid_argument( __func__ );
 	}
-	avg_[ch]  = y/nelms_;
+	// the raw sums are exact; samples are scaled as
+	//   scl * ( raw - off )
+	double scl = getScaleCorrection( ch );
+	double off = scopeParams()->afeParams[ch].postGainOffsetTick;
+	double avg = (double)st.sum / (double)nelms_;
+	double var = ( (double)st.sumSq - avg * (double)st.sum ) / (double)nelms_;
 
-	y = 0.0;
-	p = getData( ch );
-	for ( int i = 0; i < nelms_; i++ ) {
-		double tmp = (*p++ - avg_[ch]);
-		y += tmp*tmp;
-	}
-	std_[ch]  = sqrt( y/nelms_ );
+	avg_[ch]    = scl * ( avg - off );
+	std_[ch]    = fabs( scl ) * sqrt( var > 0.0 ? var : 0.0 );
+	rawMin_[ch] = st.min;
+	rawMax_[ch] = st.max;
 
-	mVld_[ch] = true;
+	mVld_[ch]   = true;
 }
@@ -0,0 +1,146 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <AcqTransport.hpp>
+#include <unistd.h>
+#include <math.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/timerfd.h>
+#include <system_error>
+#include <stdexcept>
+
+int
+createRateTimer(double rateHz)
+{
+	int tfd;
+	if ( ! (rateHz > 0.0) ) {
+		throw std::invalid_argument( __func__ );
+	}
+	if ( (tfd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC )) < 0 ) {
+		throw std::system_error( errno, std::system_category(), __func__ );
+	}
+	struct itimerspec its;
+	double            per = 1.0/rateHz;
+	its.it_interval.tv_sec  = (time_t)per;
+	its.it_interval.tv_nsec = (long)( (per - (double)its.it_interval.tv_sec) * 1.0E9 );
+	if ( 0 == its.it_interval.tv_sec && 0 == its.it_interval.tv_nsec ) {
+		its.it_interval.tv_nsec = 1;
+	}
+	its.it_value = its.it_interval;
+	if ( timerfd_settime( tfd, 0, &its, nullptr ) ) {
+		int err = errno;
+		close( tfd );
+		throw std::system_error( err, std::system_category(), __func__ );
+	}
+	return tfd;
+}
+
+uint64_t
+readRateTimer(int tfd)
+{
+	uint64_t exp;
+	if ( ::read( tfd, &exp, sizeof(exp) ) != sizeof(exp) ) {
+		if ( EAGAIN == errno ) {
+			return 0;
+		}
+		throw std::system_error( errno, std::system_category(), __func__ );
+	}
+	return exp;
+}
+
+template <typename T>
+static void
+mkPattern(T *p, unsigned nch, unsigned period, double ampl)
+{
+	for ( unsigned i = 0; i < period; ++i ) {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			double v;
+			if ( (ch & 1) ) {
+				v = ( (i / (period/8)) & 1 ) ? ampl : -ampl;
+			} else {
+				v = ampl * sin( 2.0*M_PI*(double)i/(double)period );
+			}
+			*p++ = static_cast<T>( lrint( v ) );
+		}
+	}
+}
+
+LoopbackTransport::LoopbackTransport(unsigned sampleSize, unsigned nch, double rateHz)
+: smplSz_ ( sampleSize ),
+  nch_    ( nch        )
+{
+	if ( ( 1 != sampleSize && 2 != sampleSize ) || 0 == nch || ! (rateHz > 0.0) ) {
+		throw std::invalid_argument( __func__ );
+	}
+	pattern_.resize( PERIOD * nch_ * smplSz_ );
+	if ( 2 == smplSz_ ) {
+		mkPattern( reinterpret_cast<int16_t*>( pattern_.data() ), nch_, PERIOD, 4000.0 );
+	} else {
+		mkPattern( reinterpret_cast<int8_t*> ( pattern_.data() ), nch_, PERIOD,   60.0 );
+	}
+
+	tfd_ = createRateTimer( rateHz );
+}
+
+LoopbackTransport::~LoopbackTransport()
+{
+	close( tfd_ );
+}
+
+void
+LoopbackTransport::flush()
+{
+	// consume a pending expiration
+	readRateTimer( tfd_ );
+}
+
+unsigned
+LoopbackTransport::read(uint16_t *hdr, uint8_t *dst, size_t size)
+{
+	uint64_t exp = readRateTimer( tfd_ );
+	if ( 0 == exp ) {
+		// no frame ready
+		return 0;
+	}
+	// whole samples of all channels only
+	size_t frmSz = nch_ * smplSz_;
+	size     -= size % frmSz;
+	// let the waveform move a little from frame to frame
+	size_t off = ( (frame_ += exp) * 7 % PERIOD ) * frmSz;
+	size_t got = 0;
+	while ( got < size ) {
+		size_t l = pattern_.size() - off;
+		if ( l > size - got ) {
+			l = size - got;
+		}
+		memcpy( dst + got, pattern_.data() + off, l );
+		got += l;
+		off  = 0;
+	}
+	*hdr = 0;
+	return got;
+}
@@ -0,0 +1,133 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <AcqCtrl.hpp>
+#include <ScopeParams.hpp>
+
+// Source of raw (interleaved) ADC frames as seen by the ScopeReader.
+class AcqTransport {
+public:
+	// descriptor which becomes readable when a frame is ready;
+	// negative if the transport must be polled.
+	virtual int
+	getReadyFD() = 0;
+
+	// read a frame into 'dst'; returns the number of bytes
+	// (0 if there was no frame).
+	virtual unsigned
+	read(uint16_t *hdr, uint8_t *dst, size_t size) = 0;
+
+	// discard a pending frame (acquired with old parameters)
+	virtual void
+	flush() = 0;
+
+	// the acquisition parameters changed; may be called
+	// concurrently with read().
+	virtual void
+	setParams(ScopeParamsCPtr)
+	{
+	}
+
+	virtual ~AcqTransport() {}
+};
+
+// non-blocking timerfd expiring at 'rateHz' (for synthetic sources)
+int createRateTimer(double rateHz);
+
+// consume pending expirations of a rate timer; returns their
+// number (0 if none are pending).
+uint64_t readRateTimer(int tfd);
+
+// the real device
+class AcqCtrlTransport : public AcqTransport {
+private:
+	AcqCtrl *acq_;
+public:
+	AcqCtrlTransport(AcqCtrl *acq)
+	: acq_( acq )
+	{
+	}
+
+	virtual int
+	getReadyFD() override
+	{
+		return acq_->getIrqFD( 0 );
+	}
+
+	virtual unsigned
+	read(uint16_t *hdr, uint8_t *dst, size_t size) override
+	{
+		return acq_->readBuf( hdr, dst, size );
+	}
+
+	virtual void
+	flush() override
+	{
+		acq_->flushBuf();
+	}
+};
+
+// Produces synthetic frames (a sine on even, a square wave on odd
+// channels) at a fixed rate; for testing and benchmarking the
+// acquisition and processing path without hardware.
+class LoopbackTransport : public AcqTransport {
+private:
+	int                   tfd_;      // timerfd
+	unsigned              smplSz_;   // bytes per sample
+	unsigned              nch_;
+	uint64_t              frame_ {0};
+	std::vector<uint8_t>  pattern_;  // one period of all channels
+
+	LoopbackTransport(const LoopbackTransport &)    = delete;
+
+	LoopbackTransport &
+	operator=(const LoopbackTransport &)  = delete;
+
+public:
+	constexpr static unsigned PERIOD = 1000; // samples
+
+	LoopbackTransport(unsigned sampleSize, unsigned nch, double rateHz);
+
+	virtual int
+	getReadyFD() override
+	{
+		return tfd_;
+	}
+
+	virtual unsigned
+	read(uint16_t *hdr, uint8_t *dst, size_t size) override;
+
+	virtual void
+	flush() override;
+
+	virtual ~LoopbackTransport();
+};
@@ -0,0 +1,180 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <AsyncAcq.hpp>
+#include <poll.h>
+#include <errno.h>
+#include <new>
+#include <string>
+#include <system_error>
+#include <stdexcept>
+
+AsyncAcq::AsyncAcq(AcqTransport *xport, BufPoolPtr bufPool, unsigned depth)
+: xport_   ( xport   ),
+  bufPool_ ( bufPool ),
+  done_    ( depth   )
+{
+}
+
+AsyncAcq::~AsyncAcq()
+{
+	stop();
+}
+
+void
+AsyncAcq::start()
+{
+	if ( ! thread_.joinable() ) {
+		stop_.store( false );
+		thread_ = std::thread( &AsyncAcq::xferLoop, this );
+	}
+}
+
+void
+AsyncAcq::stop()
+{
+	if ( thread_.joinable() ) {
+		stop_.store( true );
+		stopEvt_.signal();
+		thread_.join();
+		stopEvt_.clear();
+	}
+	while ( done_.tryPopHead() )
+		;
+}
+
+void
+AsyncAcq::flush()
+{
+	gen_++;
+	while ( done_.tryPopHead() ) {
+		flushed_++;
+	}
+}
+
+AcqCompletion
+AsyncAcq::tryPop()
+{
+	AcqCompletion c;
+	// clear first so we do not miss a completion that is
+	// signalled while we are popping
+	doneEvt_.clear();
+	while ( (c = done_.tryPopHead()) ) {
+		if ( c.gen == gen_.load() ) {
+			break;
+		}
+		// transfer started before a flush
+		flushed_++;
+	}
+	return c;
+}
+
+bool
+AsyncAcq::waitReady(int readyFD)
+{
+	struct pollfd pfd[2];
+	int           nfds = 0;
+	int           timo = 100; // polling mode; milli-seconds
+
+	pfd[nfds].fd     = stopEvt_.getFD();
+	pfd[nfds].events = POLLIN;
+	nfds++;
+	if ( readyFD >= 0 ) {
+		pfd[nfds].fd     = readyFD;
+		pfd[nfds].events = POLLIN;
+		nfds++;
+		timo             = -1;
+	}
+	int st;
+	while ( (st = poll( pfd, nfds, timo )) < 0 ) {
+		if ( EINTR != errno ) {
+			throw std::system_error( errno, std::generic_category(), __func__ );
+		}
+	}
+	if ( stop_.load() ) {
+		return false;
+	}
+	if ( nfds > 1 && (pfd[1].revents & ~POLLIN) ) {
+		throw std::runtime_error( std::string(__func__) + " poll error on IRQ read" );
+	}
+	return true;
+}
+
+void
+AsyncAcq::complete(AcqCompletion &c)
+{
+	transfers_++;
+	while ( ! done_.tryPushTail( c ) ) {
+		// consumer is lagging; discard the oldest frame
+		if ( done_.tryPopHead() ) {
+			dropped_++;
+		}
+	}
+	doneEvt_.signal();
+}
+
+void
+AsyncAcq::xferLoop()
+{
+	int           readyFD = xport_->getReadyFD();
+	unsigned      gen     = gen_.load();
+	AcqCompletion c;
+
+	while ( ! stop_.load() ) {
+		// have the buffer ready before the device is
+		if ( ! c.buf ) {
+			try {
+				c.buf = bufPool_->get();
+			} catch ( std::bad_alloc & ) {
+				// all buffers are downstream; wait for one to
+				// be returned.
+				poolEmpty_++;
+				if ( ! waitReady( -1 ) ) {
+					break;
+				}
+				continue;
+			}
+		}
+
+		if ( ! waitReady( readyFD ) ) {
+			break;
+		}
+
+		unsigned g = gen_.load();
+		if ( g != gen ) {
+			// a frame that is pending now was acquired with
+			// old parameters
+			xport_->flush();
+			gen = g;
+		}
+
+		c.gen    = g;
+		c.nbytes = xport_->read( &c.hdr, c.buf->getRawData(), c.buf->getRawSize() );
+		if ( c.nbytes > 0 ) {
+			complete( c );
+		}
+	}
+}
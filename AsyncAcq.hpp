@@ -0,0 +1,141 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <thread>
+#include <atomic>
+
+#include <Scope.hpp>
+#include <BufPool.hpp>
+#include <EventFD.hpp>
+#include <AcqTransport.hpp>
+
+// A frame transferred by AsyncAcq
+struct AcqCompletion {
+	BufPtr      buf;
+	uint16_t    hdr    {0};
+	unsigned    nbytes {0};
+	unsigned    gen    {0}; // AsyncAcq generation at the start of the transfer
+
+	void
+	swap(AcqCompletion &o)
+	{
+		buf.swap( o.buf );
+		std::swap( hdr,    o.hdr    );
+		std::swap( nbytes, o.nbytes );
+		std::swap( gen,    o.gen    );
+	}
+
+	explicit operator bool() const
+	{
+		return !! buf;
+	}
+};
+
+// Asynchronous acquisition: a transfer thread keeps the next buffer
+// from the pool ready and starts reading as soon as the device signals
+// that a frame is available. Up to 'depth' completed frames are held
+// until the consumer picks them up (if the consumer is lagging then the
+// oldest completed frame is dropped). Completions are signalled on a
+// descriptor so the consumer may poll() on it along with others.
+class AsyncAcq {
+private:
+	AcqTransport               *xport_;
+	BufPoolPtr                  bufPool_;
+	BufRing<AcqCompletion>      done_;
+	EventFD                     doneEvt_;
+	EventFD                     stopEvt_;
+	std::thread                 thread_;
+	std::atomic<bool>           stop_      {false};
+	// bumped by flush(); transfers started earlier are discarded
+	std::atomic<unsigned>       gen_       {0};
+
+	std::atomic<uint64_t>       transfers_ {0};
+	std::atomic<uint64_t>       dropped_   {0};
+	std::atomic<uint64_t>       flushed_   {0};
+	std::atomic<uint64_t>       poolEmpty_ {0};
+
+	AsyncAcq(const AsyncAcq &)    = delete;
+
+	AsyncAcq &
+	operator=(const AsyncAcq &)   = delete;
+
+	void xferLoop();
+
+	// returns false if we were stopped while waiting
+	bool waitReady(int readyFD);
+
+	void complete(AcqCompletion &c);
+
+public:
+	AsyncAcq(AcqTransport *xport, BufPoolPtr bufPool, unsigned depth);
+
+	// number of buffers AsyncAcq may hold (in addition to
+	// those handed to the consumer)
+	unsigned
+	getBufsHeld() const
+	{
+		return done_.depth() + 1;
+	}
+
+	void start();
+	void stop();
+
+	// transfer thread (valid between start() and stop())
+	std::thread::native_handle_type
+	nativeHandle()
+	{
+		return thread_.native_handle();
+	}
+
+	// readable when there are completed frames
+	int
+	getFD()
+	{
+		return doneEvt_.getFD();
+	}
+
+	// returns an empty completion if there is no (current) frame
+	AcqCompletion tryPop();
+
+	// discard pending and ongoing transfers (parameters changed)
+	void flush();
+
+	uint64_t getTransfers() const { return transfers_.load(); }
+	uint64_t getDropped()   const { return dropped_.load();   }
+	uint64_t getFlushed()   const { return flushed_.load();   }
+	uint64_t getPoolEmpty() const { return poolEmpty_.load(); }
+
+	size_t
+	getFill()
+	{
+		return done_.fill();
+	}
+
+	~AsyncAcq();
+};
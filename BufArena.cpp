@@ -0,0 +1,99 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <BufArena.hpp>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+#include <new>
+
+#define HUGE_PAGE_SIZE (2UL*1024UL*1024UL)
+
+static void
+warnOnce(std::atomic<bool> *warned, const char *msg, int err)
+{
+	if ( ! warned->exchange( true ) ) {
+		fprintf( stderr, "Warning: BufArena: %s (%s)\n", msg, strerror( err ) );
+	}
+}
+
+BufArena::BufArena(size_t size, unsigned flags)
+: mem_     ( MAP_FAILED ),
+  size_    ( size       ),
+  mapSize_ ( size       )
+{
+static std::atomic<bool> hugeWarned { false };
+static std::atomic<bool> lockWarned { false };
+
+	if ( 0 == size ) {
+		throw std::bad_alloc();
+	}
+
+	if ( (flags & HUGE_PAGES) ) {
+		size_t hsz = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+		mem_ = mmap( nullptr, hsz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0 );
+		if ( MAP_FAILED != mem_ ) {
+			mapSize_ = hsz;
+		}
+	}
+
+	if ( MAP_FAILED == mem_ ) {
+		size_t psz = sysconf( _SC_PAGESIZE );
+		mapSize_   = (size + psz - 1) & ~(psz - 1);
+		// transparent huge pages must be requested before the
+		// pages are faulted in; hence no MAP_POPULATE here.
+		mem_ = mmap( nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if ( MAP_FAILED == mem_ ) {
+			throw std::bad_alloc();
+		}
+		if ( (flags & HUGE_PAGES) ) {
+#ifdef MADV_HUGEPAGE
+			if ( madvise( mem_, mapSize_, MADV_HUGEPAGE ) ) {
+				warnOnce( &hugeWarned, "no huge pages available", errno );
+			}
+#else
+			warnOnce( &hugeWarned, "no huge pages available", ENOSYS );
+#endif
+		}
+		// pre-fault
+		for ( size_t off = 0; off < mapSize_; off += psz ) {
+			static_cast<volatile char*>( mem_ )[off] = 0;
+		}
+	}
+
+	if ( (flags & LOCKED) && mlock( mem_, mapSize_ ) ) {
+		warnOnce( &lockWarned, "unable to lock buffer memory", errno );
+	}
+}
+
+BufArena::~BufArena()
+{
+	// also unlocks
+	munmap( mem_, mapSize_ );
+}
@@ -0,0 +1,76 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stddef.h>
+
+// A single anonymous memory mapping holding all arrays of a buffer.
+// The mapping is pre-faulted so no page faults are taken when the
+// buffer is first used. Optionally, huge pages are requested (explicit
+// MAP_HUGETLB pages if the system has some reserved, transparent huge
+// pages otherwise) and the memory is locked. Both options are advisory;
+// if they cannot be honored a warning is printed once.
+class BufArena {
+private:
+	void     *mem_;
+	size_t    size_;
+	size_t    mapSize_;
+
+	BufArena(const BufArena &)    = delete;
+
+	BufArena &
+	operator=(const BufArena &)   = delete;
+
+public:
+	// sub-arrays are aligned to (at least) this
+	constexpr static size_t ALIGNMENT  = 64;
+
+	constexpr static unsigned HUGE_PAGES = (1 << 0);
+	constexpr static unsigned LOCKED     = (1 << 1);
+
+	BufArena(size_t size, unsigned flags = 0);
+
+	static size_t
+	align(size_t sz)
+	{
+		return (sz + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	void *
+	data()
+	{
+		return mem_;
+	}
+
+	size_t
+	size() const
+	{
+		return size_;
+	}
+
+	~BufArena();
+};
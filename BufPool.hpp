@@ -27,9 +27,21 @@
 #pragma once
 
 #include <memory>
+#include <cstddef>
+#include <vector>
+#include <utility>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 class FreeList {
 	private:
@@ -77,6 +89,20 @@ class FreeList {
 			}
 		}
 
+		// allocate/release the memory of an element (which is
+		// subsequently managed by push/pop)
+		virtual void *
+		newNode(size_t sz)
+		{
+			return ::operator new( sz );
+		}
+
+		virtual void
+		deleteNode(void *p)
+		{
+			::operator delete( p );
+		}
+
 		virtual void *
 		pop(size_t sz, bool blocking = false)
 		{
@@ -124,7 +150,207 @@ class FreeList {
 				std::terminate();
 			}
 			while ( nelm_ > 0 ) {
-				::operator delete( pop( size_ ) );
+				deleteNode( pop( size_ ) );
+			}
+		}
+};
+
+// Blocking wait for a condition which is published with atomics
+// (an 'event count' built on a linux futex). A waiter calls
+// prepareWait(), re-checks the condition and then either calls
+// cancelWait() or wait(); a notifier calls notify() after making
+// the condition true. Only notifies if there are waiters, i.e.,
+// the fast path is a single load.
+class FutexEvent {
+	std::atomic<uint32_t>            seq_     {0};
+	std::atomic<uint32_t>            waiters_ {0};
+
+public:
+	uint32_t
+	prepareWait()
+	{
+		waiters_.fetch_add( 1, std::memory_order_seq_cst );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		return seq_.load( std::memory_order_seq_cst );
+	}
+
+	void
+	cancelWait()
+	{
+		waiters_.fetch_sub( 1, std::memory_order_relaxed );
+	}
+
+	// may return spuriously; 'timo' (relative) may be NULL
+	void
+	wait(uint32_t key, const struct timespec *timo = nullptr)
+	{
+		syscall( SYS_futex, reinterpret_cast<uint32_t*>( &seq_ ), FUTEX_WAIT_PRIVATE, key, timo, nullptr, 0 );
+		waiters_.fetch_sub( 1, std::memory_order_relaxed );
+	}
+
+	void
+	notify(bool all = false)
+	{
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if ( waiters_.load( std::memory_order_seq_cst ) ) {
+			seq_.fetch_add( 1, std::memory_order_seq_cst );
+			syscall( SYS_futex, reinterpret_cast<uint32_t*>( &seq_ ), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0 );
+		}
+	}
+};
+
+// Drop-in replacement for FreeList which does not lock: a Treiber
+// stack of nodes. Nodes are identified by an index into a table so
+// that the head (index + ABA tag) fits into a single 64-bit word;
+// the links live in a small header in front of each element where
+// they are not clobbered by the element's user. The number of
+// nodes is limited to 'capacity'. pop(sz, true) blocks on a futex.
+class LFFreeList {
+	private:
+		struct alignas(alignof(std::max_align_t)) Hdr {
+			uint32_t                     idx;
+			std::atomic<uint32_t>        next;
+		};
+
+		constexpr static uint32_t        NIL = 0xffffffff;
+
+		std::unique_ptr<Hdr*[]>          nodes_;
+		uint32_t                         capa_;
+		std::atomic<uint32_t>            nnod_ {0};
+		// (tag << 32) | index
+		std::atomic<uint64_t>            head_ {NIL};
+		size_t                           extr_;
+		std::atomic<size_t>              nelm_ {0};
+		std::atomic<size_t>              totl_ {0};
+		std::atomic<size_t>              size_ {0};
+		FutexEvent                       avail_;
+
+		LFFreeList(const LFFreeList &)   = delete;
+
+		LFFreeList &
+		operator=(const LFFreeList &)    = delete;
+
+		static Hdr *
+		hdr(void *p)
+		{
+			return static_cast<Hdr*>( p ) - 1;
+		}
+
+		void *
+		tryPop()
+		{
+			uint64_t h = head_.load( std::memory_order_acquire );
+			while ( NIL != static_cast<uint32_t>( h ) ) {
+				Hdr      *n  = nodes_[ static_cast<uint32_t>( h ) ];
+				// if 'n' has been popped (and pushed) by someone else
+				// meanwhile then the tag has changed and we retry
+				uint64_t  nh = ( (h >> 32) + 1 ) << 32 | n->next.load( std::memory_order_relaxed );
+				if ( head_.compare_exchange_weak( h, nh, std::memory_order_acquire, std::memory_order_acquire ) ) {
+					nelm_.fetch_sub( 1, std::memory_order_relaxed );
+					return static_cast<void*>( n + 1 );
+				}
+			}
+			return nullptr;
+		}
+
+	public:
+
+		LFFreeList(size_t extr, uint32_t capacity = 1024)
+		: nodes_( new Hdr*[capacity] ),
+		  capa_ ( capacity ),
+		  extr_ ( extr     )
+		{
+		}
+
+		void
+		checkSize( size_t s )
+		{
+			size_t expected = 0;
+			if ( ! size_.compare_exchange_strong( expected, s ) && expected != s ) {
+				throw std::bad_alloc();
+			}
+		}
+
+		size_t
+		getExtra()
+		{
+			return extr_;
+		}
+
+		void
+		added(size_t n)
+		{
+			totl_ += n;
+		}
+
+		void *
+		newNode(size_t sz)
+		{
+			uint32_t idx = nnod_.fetch_add( 1 );
+			if ( idx >= capa_ ) {
+				nnod_--;
+				throw std::bad_alloc();
+			}
+			Hdr *n = static_cast<Hdr*>( ::operator new( sizeof(Hdr) + sz ) );
+			n->idx = idx;
+			n->next.store( NIL, std::memory_order_relaxed );
+			// published by the release in push()
+			nodes_[idx] = n;
+			return static_cast<void*>( n + 1 );
+		}
+
+		void
+		deleteNode(void *p)
+		{
+			::operator delete( static_cast<void*>( hdr( p ) ) );
+		}
+
+		void *
+		pop(size_t sz, bool blocking = false)
+		{
+			if ( sz > size_.load( std::memory_order_relaxed ) ) {
+				throw std::bad_alloc();
+			}
+			void *p;
+			while ( ! (p = tryPop()) && blocking ) {
+				uint32_t key = avail_.prepareWait();
+				if ( (p = tryPop()) ) {
+					avail_.cancelWait();
+					break;
+				}
+				avail_.wait( key );
+			}
+			return p;
+		}
+
+		void
+		push(size_t sz, void *p)
+		{
+			if ( ! p ) {
+				return;
+			}
+			if ( sz < size_.load( std::memory_order_relaxed ) ) {
+				throw std::bad_alloc();
+			}
+			Hdr      *n = hdr( p );
+			uint64_t  h = head_.load( std::memory_order_relaxed );
+			uint64_t  nh;
+			do {
+				n->next.store( static_cast<uint32_t>( h ), std::memory_order_relaxed );
+				nh = ( (h >> 32) + 1 ) << 32 | n->idx;
+			} while ( ! head_.compare_exchange_weak( h, nh, std::memory_order_release, std::memory_order_relaxed ) );
+			nelm_.fetch_add( 1, std::memory_order_relaxed );
+			avail_.notify();
+		}
+
+		~LFFreeList() noexcept(false)
+		{
+			if ( totl_.load() != nelm_.load() ) {
+				// fatal error; not all elements returned
+				throw std::runtime_error( "Cannot destroy LFFreeList w/o all nodes returned!" );
+			}
+			for ( uint32_t i = 0; i < nnod_.load(); ++i ) {
+				::operator delete( static_cast<void*>( nodes_[i] ) );
 			}
 		}
 };
@@ -138,8 +364,9 @@ public:
 	}
 };
 
-template <typename T>
-class BufPool : public FreeList {
+// The free list may be a FreeList (default) or a LFFreeList
+template <typename T, typename FL = FreeList>
+class BufPool : public FL {
 
 	class BadAlloc : public std::bad_alloc {
 	public:
@@ -152,9 +379,9 @@ class BufPool : public FreeList {
 
 	template <typename TT>
 	struct ListAlloc {
-		FreeList *freeList_;
+		FL       *freeList_;
 
-		ListAlloc( FreeList *fl ) : freeList_ ( fl ) {}
+		ListAlloc( FL *fl ) : freeList_ ( fl ) {}
 
 		ListAlloc( const ListAlloc<T> &rhs ) { freeList_ = rhs.freeList_; }
 
@@ -179,7 +406,7 @@ class BufPool : public FreeList {
 
 	template <typename TT>
 	struct NewAlloc : public ListAlloc<TT> {
-		NewAlloc( FreeList *fl ) : ListAlloc<TT> ( fl ) {}
+		NewAlloc( FL *fl ) : ListAlloc<TT> ( fl ) {}
 
 		NewAlloc( const NewAlloc<T> &rhs ) : ListAlloc<TT>( rhs ) {}
 
@@ -187,7 +414,7 @@ class BufPool : public FreeList {
 		allocate( size_t n )
 		{
 			this->freeList_->checkSize( sizeof(TT) );
-			TT *rv = static_cast<TT*>( ::operator new( sizeof(TT) + this->freeList_->getExtra() ) );
+			TT *rv = static_cast<TT*>( this->freeList_->newNode( sizeof(TT) + this->freeList_->getExtra() ) );
 			if ( ! rv ) {
 				throw BadAlloc( sizeof(TT) );
 			}
@@ -206,8 +433,9 @@ public:
 
 	typedef std::shared_ptr<T> BufPtr;
 
-	BufPool(size_t extra)
-	: FreeList( extra )
+	template <class... FLArgs>
+	BufPool(size_t extra, FLArgs && ... flArgs)
+	: FL( extra, flArgs... )
 	{
 	}
 
@@ -216,7 +444,7 @@ protected:
 	add()
 	{
 		auto rv = std::allocate_shared< T, NewAlloc<T> >( NewAlloc<T>(this) );
-		added(1);
+		this->added(1);
 		return rv;
 	}
 
@@ -297,3 +525,318 @@ public:
 
 	}
 };
+
+// Lock-free counterpart of BufFifo: a bounded multi-producer/
+// multi-consumer ring (D. Vyukov's algorithm; every cell carries a
+// sequence number which tells producers and consumers whether it
+// is theirs). The elements need not be BufNodes. pushTail/popHead
+// block on a futex while the ring is full/empty; the depth is rounded
+// up to a power of two.
+template <typename T, typename PT = std::shared_ptr<T> >
+class LFBufFifo {
+	struct alignas(64) Cell {
+		std::atomic<size_t>      seq;
+		PT                       el;
+	};
+
+	std::unique_ptr<Cell[]>      cells_;
+	size_t                       mask_;
+	alignas(64)
+	std::atomic<size_t>          tail_ {0};
+	alignas(64)
+	std::atomic<size_t>          head_ {0};
+	FutexEvent                   notEmpty_;
+	FutexEvent                   notFull_;
+
+	LFBufFifo(const LFBufFifo &)    = delete;
+
+	LFBufFifo &
+	operator=(const LFBufFifo &)  = delete;
+
+	static size_t
+	pow2(size_t depth)
+	{
+		size_t n = 1;
+		while ( n < depth ) {
+			n <<= 1;
+		}
+		return n;
+	}
+
+public:
+	LFBufFifo(size_t depth = 64)
+	: cells_( new Cell[ pow2( depth ) ] ),
+	  mask_ ( pow2( depth ) - 1         )
+	{
+		for ( size_t i = 0; i <= mask_; ++i ) {
+			cells_[i].seq.store( i, std::memory_order_relaxed );
+		}
+	}
+
+	size_t
+	depth() const
+	{
+		return mask_ + 1;
+	}
+
+	// returns false (and leaves 'el' alone) if the ring is full;
+	// on success 'el' is moved into the ring.
+	bool tryPushTail(PT &el)
+	{
+		size_t pos = tail_.load( std::memory_order_relaxed );
+		for (;;) {
+			Cell     &c   = cells_[ pos & mask_ ];
+			size_t    seq = c.seq.load( std::memory_order_acquire );
+			intptr_t  dif = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos );
+			if ( 0 == dif ) {
+				if ( tail_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					c.el.swap( el );
+					c.seq.store( pos + 1, std::memory_order_release );
+					notEmpty_.notify();
+					return true;
+				}
+			} else if ( dif < 0 ) {
+				return false;
+			} else {
+				pos = tail_.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	void pushTail(PT el)
+	{
+		while ( ! tryPushTail( el ) ) {
+			uint32_t key = notFull_.prepareWait();
+			if ( tryPushTail( el ) ) {
+				notFull_.cancelWait();
+				break;
+			}
+			notFull_.wait( key );
+		}
+	}
+
+	// returns an empty pointer if the ring is empty
+	PT tryPopHead()
+	{
+		PT     el;
+		size_t pos = head_.load( std::memory_order_relaxed );
+		for (;;) {
+			Cell     &c   = cells_[ pos & mask_ ];
+			size_t    seq = c.seq.load( std::memory_order_acquire );
+			intptr_t  dif = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos + 1 );
+			if ( 0 == dif ) {
+				if ( head_.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					el.swap( c.el );
+					c.seq.store( pos + mask_ + 1, std::memory_order_release );
+					notFull_.notify();
+					return el;
+				}
+			} else if ( dif < 0 ) {
+				return el;
+			} else {
+				pos = head_.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	PT popHead()
+	{
+		PT el;
+		while ( ! (el = tryPopHead()) ) {
+			uint32_t key = notEmpty_.prepareWait();
+			if ( (el = tryPopHead()) ) {
+				notEmpty_.cancelWait();
+				break;
+			}
+			notEmpty_.wait( key );
+		}
+		return el;
+	}
+};
+
+// Bounded FIFO of (smart) pointers; connects pipeline stages.
+// Unlike BufFifo the elements need not be BufNodes and the
+// number of elements in flight is limited by the depth.
+template <typename PT>
+class BufRing {
+	std::mutex                   mutx_;
+	std::condition_variable      cond_;
+	std::vector<PT>              ring_;
+	size_t                       head_ {0};
+	size_t                       fill_ {0};
+	size_t                       hiwm_ {0};
+
+	BufRing(const BufRing &)    = delete;
+
+	BufRing &
+	operator=(const BufRing &)  = delete;
+
+	// must hold the lock
+	void put(PT &el)
+	{
+		ring_[ (head_ + fill_) % ring_.size() ].swap( el );
+		if ( ++fill_ > hiwm_ ) {
+			hiwm_ = fill_;
+		}
+	}
+
+	// must hold the lock
+	PT get()
+	{
+		PT el;
+		el.swap( ring_[ head_ ] );
+		head_ = (head_ + 1) % ring_.size();
+		fill_--;
+		return el;
+	}
+
+public:
+	BufRing(size_t depth)
+	: ring_( depth ? depth : 1 )
+	{
+	}
+
+	size_t
+	depth() const
+	{
+		return ring_.size();
+	}
+
+	size_t
+	fill()
+	{
+		std::lock_guard g( mutx_ );
+		return fill_;
+	}
+
+	size_t
+	highWaterMark()
+	{
+		std::lock_guard g( mutx_ );
+		return hiwm_;
+	}
+
+	// returns false (and leaves 'el' alone) if the ring is full;
+	// on success 'el' is moved into the ring.
+	bool tryPushTail(PT &el)
+	{
+		{
+			std::lock_guard g( mutx_ );
+			if ( fill_ == ring_.size() ) {
+				return false;
+			}
+			put( el );
+		}
+		cond_.notify_all();
+		return true;
+	}
+
+	void pushTail(PT &el)
+	{
+		{
+			std::unique_lock g( mutx_ );
+			while ( fill_ == ring_.size() ) {
+				cond_.wait( g );
+			}
+			put( el );
+		}
+		cond_.notify_all();
+	}
+
+	// returns an empty pointer if the ring is empty
+	PT tryPopHead()
+	{
+		PT el;
+		{
+			std::lock_guard g( mutx_ );
+			if ( 0 == fill_ ) {
+				return el;
+			}
+			el = get();
+		}
+		cond_.notify_all();
+		return el;
+	}
+
+	PT popHead()
+	{
+		PT el;
+		{
+			std::unique_lock g( mutx_ );
+			while ( 0 == fill_ ) {
+				cond_.wait( g );
+			}
+			el = get();
+		}
+		cond_.notify_all();
+		return el;
+	}
+};
+
+// Single-slot mailbox between one producer and one consumer thread
+// which never blocks. A newer element replaces an element that has
+// not been taken yet. Implemented as a triple buffer: producer and
+// consumer each own one slot and atomically exchange it with the
+// shared 'middle' slot. Elements are (smart) pointers or any other
+// swappable objects.
+template <typename PT>
+class BufMailbox {
+	constexpr static unsigned    NEW = 4; // flags 'middle' as not taken yet
+	constexpr static unsigned    IDX = 3;
+
+	PT                           slots_[3];
+	unsigned                     back_   {0}; // producer's slot
+	unsigned                     front_  {2}; // consumer's slot
+	std::atomic<unsigned>        middle_ {1};
+
+	BufMailbox(const BufMailbox &)    = delete;
+
+	BufMailbox &
+	operator=(const BufMailbox &)  = delete;
+
+public:
+	BufMailbox()
+	{
+	}
+
+	// producer: move 'el' into the mailbox; on return 'el' holds
+	// the element that was replaced (if any). Returns true if the
+	// mailbox was empty, i.e., the consumer needs to be notified.
+	bool post(PT &el)
+	{
+		using std::swap;
+		swap( slots_[ back_ ], el );
+		unsigned old = middle_.exchange( back_ | NEW, std::memory_order_acq_rel );
+		back_        = old & IDX;
+		swap( el, slots_[ back_ ] );
+		return ! (old & NEW);
+	}
+
+	// consumer: swap the newest element into 'el'; returns false
+	// (and leaves 'el' alone) if there is nothing new. The previous
+	// content of 'el' is eventually handed back to the producer.
+	bool take(PT &el)
+	{
+		using std::swap;
+		if ( ! (middle_.load( std::memory_order_acquire ) & NEW) ) {
+			return false;
+		}
+		front_ = middle_.exchange( front_, std::memory_order_acq_rel ) & IDX;
+		swap( el, slots_[ front_ ] );
+		return true;
+	}
+
+	// consumer: returns an empty pointer if there is nothing new
+	PT take()
+	{
+		PT el;
+		take( el );
+		return el;
+	}
+
+	// an element is waiting for the consumer
+	bool full() const
+	{
+		return !! (middle_.load( std::memory_order_acquire ) & NEW);
+	}
+};
@@ -0,0 +1,52 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <memory>
+
+#include <ADCBuf.hpp>
+#include <Persistence.hpp>
+#include <Waterfall.hpp>
+
+// precision of the processed samples (time-domain, FFT); float
+// halves the memory footprint (select with -DUSE_FLOAT_SAMPLES=ON).
+#ifdef CONFIG_FLOAT_SAMPLES
+typedef float                                 SampleType;
+#else
+typedef double                                SampleType;
+#endif
+
+typedef ADCBufPool<SampleType>                BufPoolType;
+typedef std::shared_ptr< BufPoolType >        BufPoolPtr;
+typedef BufPoolType::ADCBufType               BufType;
+typedef BufPoolType::ADCBufPtr                BufPtr;
+
+typedef Persistence<SampleType>               PersistenceType;
+typedef std::shared_ptr< PersistenceType >    PersistencePtr;
+
+typedef Waterfall<SampleType>                 WaterfallType;
+typedef std::shared_ptr< WaterfallType >      WaterfallPtr;
@@ -0,0 +1,927 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <DSPKernels.hpp>
+
+#include <string.h>
+#include <math.h>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DSPK_X86 1
+#include <immintrin.h>
+#endif
+
+using DSPKernels::RawStats;
+
+namespace {
+
+template <typename T, typename D>
+using DeintFn = void (*)(const T *, unsigned, size_t, D * const [], const double [], const double [], RawStats []);
+
+template <typename D>
+using LogModFn = void (*)(const D (*)[2], size_t, D *);
+
+template <typename D>
+using BinFn = void (*)(const D *, size_t, double, double, uint32_t, uint32_t *);
+
+// reference implementation; process samples 'from' .. 'nelms - 1'
+// and accumulate into 'stats'. A non-zero NCH fixes the number of
+// channels at compile time (which lets the compiler unroll the inner
+// loop); NCH == 0 uses 'nch'.
+template <unsigned NCH, typename T, typename D>
+void
+deintScalarN(const T *src, unsigned nch, size_t from, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	const unsigned n = NCH ? NCH : nch;
+	src += from*n;
+	for ( size_t i = from; i < nelms; ++i, src += n ) {
+		for ( unsigned ch = 0; ch < n; ++ch ) {
+			if ( ! dst[ch] ) {
+				continue;
+			}
+			int32_t v = src[ch];
+			dst[ch][i] = static_cast<D>( scl[ch]*( static_cast<double>( v ) - off[ch] ) );
+			stats[ch].sum   += v;
+			stats[ch].sumSq += v*v;
+			if ( v < stats[ch].min ) {
+				stats[ch].min = v;
+			}
+			if ( v > stats[ch].max ) {
+				stats[ch].max = v;
+			}
+		}
+	}
+}
+
+// dispatch the common channel counts
+template <typename T, typename D>
+void
+deintScalar(const T *src, unsigned nch, size_t from, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	switch ( nch ) {
+		case 1:  deintScalarN<1>( src, nch, from, nelms, dst, scl, off, stats ); break;
+		case 2:  deintScalarN<2>( src, nch, from, nelms, dst, scl, off, stats ); break;
+		case 4:  deintScalarN<4>( src, nch, from, nelms, dst, scl, off, stats ); break;
+		default: deintScalarN<0>( src, nch, from, nelms, dst, scl, off, stats ); break;
+	}
+}
+
+template <typename T, typename D>
+void
+deintScalar(const T *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	deintScalar( src, nch, 0, nelms, dst, scl, off, stats );
+}
+
+// the squares are always computed in double precision
+template <typename D>
+static inline double
+norm2(const D c[2])
+{
+	double re = c[0];
+	double im = c[1];
+	return re*re + im*im;
+}
+
+template <typename D>
+void
+logModExact(const D (*src)[2], size_t n, D *dst)
+{
+	for ( size_t i = 0; i < n; ++i ) {
+		dst[i] = static_cast<D>( 0.5*log10( norm2( src[i] ) ) );
+	}
+}
+
+// log10(x) = log10(2) * exponent + log10(mantissa) with the mantissa
+// normalized to [sqrt(1/2), sqrt(2)) and
+//
+//   ln(m) = 2 * atanh( t ) = 2 * ( t + t^3/3 + t^5/5 + ... ), t = (m-1)/(m+1)
+//
+// |t| < 0.172, the truncation error of the series (after t^7/7)
+// is below 2E-8.
+constexpr uint64_t MANT_MSK = 0x000fffffffffffffULL;
+constexpr uint64_t EXP_ONE  = 0x3ff0000000000000ULL;
+
+static inline double
+logModFast(double p)
+{
+	if ( ! (p > 0.0) ) {
+		return 0.0 == p ? -HUGE_VAL : NAN;
+	}
+	uint64_t b;
+	double   m;
+	memcpy( &b, &p, sizeof(b) );
+	int      e = static_cast<int>( b >> 52 ) - 1023;
+	b          = ( b & MANT_MSK ) | EXP_ONE;
+	memcpy( &m, &b, sizeof(m) );
+	if ( m > M_SQRT2 ) {
+		m *= 0.5;
+		e++;
+	}
+	double t  = (m - 1.0)/(m + 1.0);
+	double t2 = t*t;
+	double l  = 2.0*t*( 1.0 + t2*( 1.0/3.0 + t2*( 1.0/5.0 + t2*( 1.0/7.0 ) ) ) );
+	// halve for the modulus
+	return 0.5*( e*(M_LN2/M_LN10) + l*M_LOG10E );
+}
+
+template <typename D>
+void
+logModFast(const D (*src)[2], size_t n, D *dst)
+{
+	for ( size_t i = 0; i < n; ++i ) {
+		dst[i] = static_cast<D>( logModFast( norm2( src[i] ) ) );
+	}
+}
+
+template <typename D>
+void
+binScalar(const D *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst)
+{
+	const double top = static_cast<double>( nbins - 1 );
+	for ( size_t i = 0; i < n; ++i ) {
+		double v = floor( ( static_cast<double>( src[i] ) - lo ) * scl );
+		if ( v < 0.0 ) {
+			v = 0.0;
+		}
+		if ( v > top ) {
+			v = top;
+		}
+		dst[i] = static_cast<uint32_t>( v );
+	}
+}
+
+// The vector kernels accumulate sums of the (integer-valued) samples
+// in double lanes which is exact as long as the lane sums stay below
+// 2^53; squares of 16-bit samples are < 2^31 so we can safely add
+// 2^20 of them before transferring the lane sums into int64.
+constexpr size_t FLUSH_ITERATIONS = (1 << 20);
+
+static void
+flushLanes(RawStats *st, const double *sum, const double *sq, const double *mn, const double *mx, unsigned nlanes)
+{
+	for ( unsigned l = 0; l < nlanes; ++l ) {
+		st->sum   += static_cast<int64_t>( sum[l] );
+		st->sumSq += static_cast<int64_t>( sq[l]  );
+		if ( mn[l] < st->min ) {
+			st->min = static_cast<int32_t>( mn[l] );
+		}
+		if ( mx[l] > st->max ) {
+			st->max = static_cast<int32_t>( mx[l] );
+		}
+	}
+}
+
+#ifdef DSPK_X86
+
+// The vector kernels de-interleave two channels by sign-extending the
+// even/odd elements of the raw data in place (shift left/arithmetic
+// shift right) and converting the resulting 32-bit integers to double;
+// a single channel is merely sign-extended. Other channel counts are
+// handled by the scalar code.
+// int -> double conversion is exact; subtract and multiply are the
+// same IEEE operations the scalar code uses. Results are rounded to
+// float on store (if requested) - just like the scalar code does.
+
+__attribute__((target("sse2")))
+static inline void
+storeOut(double *d, __m128d v)
+{
+	_mm_storeu_pd( d, v );
+}
+
+__attribute__((target("sse2")))
+static inline void
+storeOut(float *d, __m128d v)
+{
+	_mm_storel_pi( reinterpret_cast<__m64*>( d ), _mm_cvtpd_ps( v ) );
+}
+
+__attribute__((target("avx2")))
+static inline void
+storeOut(double *d, __m256d v)
+{
+	_mm256_storeu_pd( d, v );
+}
+
+__attribute__((target("avx2")))
+static inline void
+storeOut(float *d, __m256d v)
+{
+	_mm_storeu_ps( d, _mm256_cvtpd_ps( v ) );
+}
+
+__attribute__((target("avx512f,avx2")))
+static inline void
+storeOut(double *d, __m512d v)
+{
+	_mm512_storeu_pd( d, v );
+}
+
+__attribute__((target("avx512f,avx2")))
+static inline void
+storeOut(float *d, __m512d v)
+{
+	_mm256_storeu_ps( d, _mm512_cvtpd_ps( v ) );
+}
+
+struct AccSSE2 {
+	__m128d sum, sq, mn, mx;
+};
+
+__attribute__((target("sse2")))
+static inline void
+init(AccSSE2 *a)
+{
+	a->sum = _mm_setzero_pd();
+	a->sq  = _mm_setzero_pd();
+	a->mn  = _mm_set1_pd(  HUGE_VAL );
+	a->mx  = _mm_set1_pd( -HUGE_VAL );
+}
+
+__attribute__((target("sse2")))
+static inline void
+flush(AccSSE2 *a, RawStats *st)
+{
+	double sum[2], sq[2], mn[2], mx[2];
+	_mm_storeu_pd( sum, a->sum );
+	_mm_storeu_pd( sq,  a->sq  );
+	_mm_storeu_pd( mn,  a->mn  );
+	_mm_storeu_pd( mx,  a->mx  );
+	flushLanes( st, sum, sq, mn, mx, 2 );
+	init( a );
+}
+
+template <typename D>
+__attribute__((target("sse2")))
+static inline void
+store4(D *d, __m128i v, __m128d s, __m128d o, AccSSE2 *a)
+{
+	__m128d lo = _mm_cvtepi32_pd( v );
+	__m128d hi = _mm_cvtepi32_pd( _mm_srli_si128( v, 8 ) );
+	storeOut( d + 0, _mm_mul_pd( _mm_sub_pd( lo, o ), s ) );
+	storeOut( d + 2, _mm_mul_pd( _mm_sub_pd( hi, o ), s ) );
+	a->sum = _mm_add_pd( a->sum, _mm_add_pd( lo, hi ) );
+	a->sq  = _mm_add_pd( a->sq,  _mm_add_pd( _mm_mul_pd( lo, lo ), _mm_mul_pd( hi, hi ) ) );
+	a->mn  = _mm_min_pd( a->mn,  _mm_min_pd( lo, hi ) );
+	a->mx  = _mm_max_pd( a->mx,  _mm_max_pd( lo, hi ) );
+}
+
+template <typename D>
+__attribute__((target("sse2")))
+static inline void
+store8(D *d, __m128i v16, __m128d s, __m128d o, AccSSE2 *a)
+{
+	store4( d + 0, _mm_srai_epi32( _mm_unpacklo_epi16( v16, v16 ), 16 ), s, o, a );
+	store4( d + 4, _mm_srai_epi32( _mm_unpackhi_epi16( v16, v16 ), 16 ), s, o, a );
+}
+
+template <typename D>
+__attribute__((target("sse2")))
+void
+deintSSE2(const int16_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m128d s0 = _mm_set1_pd( scl[0] ), o0 = _mm_set1_pd( off[0] );
+		__m128d s1 = _mm_set1_pd( scl[1] ), o1 = _mm_set1_pd( off[1] );
+		AccSSE2 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		for ( size_t n = 0; i + 4 <= nelms; i += 4 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + 2*i ) );
+			if ( dst[0] ) {
+				store4( dst[0] + i, _mm_srai_epi32( _mm_slli_epi32( x, 16 ), 16 ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store4( dst[1] + i, _mm_srai_epi32( x, 16 ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		// no de-interleaving necessary
+		__m128d s0 = _mm_set1_pd( scl[0] ), o0 = _mm_set1_pd( off[0] );
+		AccSSE2 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 8 <= nelms; i += 8 ) {
+			store8( dst[0] + i, _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/4 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+template <typename D>
+__attribute__((target("sse2")))
+void
+deintSSE2(const int8_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m128d s0 = _mm_set1_pd( scl[0] ), o0 = _mm_set1_pd( off[0] );
+		__m128d s1 = _mm_set1_pd( scl[1] ), o1 = _mm_set1_pd( off[1] );
+		AccSSE2 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		for ( size_t n = 0; i + 8 <= nelms; i += 8 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + 2*i ) );
+			if ( dst[0] ) {
+				store8( dst[0] + i, _mm_srai_epi16( _mm_slli_epi16( x, 8 ), 8 ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store8( dst[1] + i, _mm_srai_epi16( x, 8 ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/4 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		__m128d s0 = _mm_set1_pd( scl[0] ), o0 = _mm_set1_pd( off[0] );
+		AccSSE2 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+			store8( dst[0] + i + 0, _mm_srai_epi16( _mm_unpacklo_epi8( x, x ), 8 ), s0, o0, &a0 );
+			store8( dst[0] + i + 8, _mm_srai_epi16( _mm_unpackhi_epi8( x, x ), 8 ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/8 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+struct AccAVX2 {
+	__m256d sum, sq, mn, mx;
+};
+
+__attribute__((target("avx2")))
+static inline void
+init(AccAVX2 *a)
+{
+	a->sum = _mm256_setzero_pd();
+	a->sq  = _mm256_setzero_pd();
+	a->mn  = _mm256_set1_pd(  HUGE_VAL );
+	a->mx  = _mm256_set1_pd( -HUGE_VAL );
+}
+
+__attribute__((target("avx2")))
+static inline void
+flush(AccAVX2 *a, RawStats *st)
+{
+	double sum[4], sq[4], mn[4], mx[4];
+	_mm256_storeu_pd( sum, a->sum );
+	_mm256_storeu_pd( sq,  a->sq  );
+	_mm256_storeu_pd( mn,  a->mn  );
+	_mm256_storeu_pd( mx,  a->mx  );
+	flushLanes( st, sum, sq, mn, mx, 4 );
+	init( a );
+}
+
+template <typename D>
+__attribute__((target("avx2")))
+static inline void
+store8(D *d, __m256i v, __m256d s, __m256d o, AccAVX2 *a)
+{
+	__m256d lo = _mm256_cvtepi32_pd( _mm256_castsi256_si128( v ) );
+	__m256d hi = _mm256_cvtepi32_pd( _mm256_extracti128_si256( v, 1 ) );
+	storeOut( d + 0, _mm256_mul_pd( _mm256_sub_pd( lo, o ), s ) );
+	storeOut( d + 4, _mm256_mul_pd( _mm256_sub_pd( hi, o ), s ) );
+	a->sum = _mm256_add_pd( a->sum, _mm256_add_pd( lo, hi ) );
+	a->sq  = _mm256_add_pd( a->sq,  _mm256_add_pd( _mm256_mul_pd( lo, lo ), _mm256_mul_pd( hi, hi ) ) );
+	a->mn  = _mm256_min_pd( a->mn,  _mm256_min_pd( lo, hi ) );
+	a->mx  = _mm256_max_pd( a->mx,  _mm256_max_pd( lo, hi ) );
+}
+
+template <typename D>
+__attribute__((target("avx2")))
+static inline void
+store16(D *d, __m256i v16, __m256d s, __m256d o, AccAVX2 *a)
+{
+	store8( d + 0, _mm256_cvtepi16_epi32( _mm256_castsi256_si128( v16 ) ), s, o, a );
+	store8( d + 8, _mm256_cvtepi16_epi32( _mm256_extracti128_si256( v16, 1 ) ), s, o, a );
+}
+
+template <typename D>
+__attribute__((target("avx2")))
+void
+deintAVX2(const int16_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m256d s0 = _mm256_set1_pd( scl[0] ), o0 = _mm256_set1_pd( off[0] );
+		__m256d s1 = _mm256_set1_pd( scl[1] ), o1 = _mm256_set1_pd( off[1] );
+		AccAVX2 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		for ( size_t n = 0; i + 8 <= nelms; i += 8 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + 2*i ) );
+			if ( dst[0] ) {
+				store8( dst[0] + i, _mm256_srai_epi32( _mm256_slli_epi32( x, 16 ), 16 ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store8( dst[1] + i, _mm256_srai_epi32( x, 16 ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		__m256d s0 = _mm256_set1_pd( scl[0] ), o0 = _mm256_set1_pd( off[0] );
+		AccAVX2 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			store16( dst[0] + i, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + i ) ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/4 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+template <typename D>
+__attribute__((target("avx2")))
+void
+deintAVX2(const int8_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m256d s0 = _mm256_set1_pd( scl[0] ), o0 = _mm256_set1_pd( off[0] );
+		__m256d s1 = _mm256_set1_pd( scl[1] ), o1 = _mm256_set1_pd( off[1] );
+		AccAVX2 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + 2*i ) );
+			if ( dst[0] ) {
+				store16( dst[0] + i, _mm256_srai_epi16( _mm256_slli_epi16( x, 8 ), 8 ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store16( dst[1] + i, _mm256_srai_epi16( x, 8 ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/4 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		__m256d s0 = _mm256_set1_pd( scl[0] ), o0 = _mm256_set1_pd( off[0] );
+		AccAVX2 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+			store16( dst[0] + i, _mm256_cvtepi8_epi16( x ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/4 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+struct AccAVX512 {
+	__m512d sum, sq, mn, mx;
+};
+
+__attribute__((target("avx512f,avx2")))
+static inline void
+init(AccAVX512 *a)
+{
+	a->sum = _mm512_setzero_pd();
+	a->sq  = _mm512_setzero_pd();
+	a->mn  = _mm512_set1_pd(  HUGE_VAL );
+	a->mx  = _mm512_set1_pd( -HUGE_VAL );
+}
+
+__attribute__((target("avx512f,avx2")))
+static inline void
+flush(AccAVX512 *a, RawStats *st)
+{
+	double sum[8], sq[8], mn[8], mx[8];
+	_mm512_storeu_pd( sum, a->sum );
+	_mm512_storeu_pd( sq,  a->sq  );
+	_mm512_storeu_pd( mn,  a->mn  );
+	_mm512_storeu_pd( mx,  a->mx  );
+	flushLanes( st, sum, sq, mn, mx, 8 );
+	init( a );
+}
+
+template <typename D>
+__attribute__((target("avx512f,avx2")))
+static inline void
+store16(D *d, __m512i v, __m512d s, __m512d o, AccAVX512 *a)
+{
+	__m512d lo = _mm512_cvtepi32_pd( _mm512_castsi512_si256( v ) );
+	__m512d hi = _mm512_cvtepi32_pd( _mm512_extracti64x4_epi64( v, 1 ) );
+	storeOut( d + 0, _mm512_mul_pd( _mm512_sub_pd( lo, o ), s ) );
+	storeOut( d + 8, _mm512_mul_pd( _mm512_sub_pd( hi, o ), s ) );
+	a->sum = _mm512_add_pd( a->sum, _mm512_add_pd( lo, hi ) );
+	a->sq  = _mm512_add_pd( a->sq,  _mm512_add_pd( _mm512_mul_pd( lo, lo ), _mm512_mul_pd( hi, hi ) ) );
+	a->mn  = _mm512_min_pd( a->mn,  _mm512_min_pd( lo, hi ) );
+	a->mx  = _mm512_max_pd( a->mx,  _mm512_max_pd( lo, hi ) );
+}
+
+template <typename D>
+__attribute__((target("avx512f,avx2")))
+void
+deintAVX512(const int16_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m512d s0 = _mm512_set1_pd( scl[0] ), o0 = _mm512_set1_pd( off[0] );
+		__m512d s1 = _mm512_set1_pd( scl[1] ), o1 = _mm512_set1_pd( off[1] );
+		AccAVX512 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m512i x = _mm512_loadu_si512( src + 2*i );
+			if ( dst[0] ) {
+				store16( dst[0] + i, _mm512_srai_epi32( _mm512_slli_epi32( x, 16 ), 16 ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store16( dst[1] + i, _mm512_srai_epi32( x, 16 ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		__m512d s0 = _mm512_set1_pd( scl[0] ), o0 = _mm512_set1_pd( off[0] );
+		AccAVX512 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + i ) );
+			store16( dst[0] + i, _mm512_cvtepi16_epi32( x ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+template <typename D>
+__attribute__((target("avx512f,avx2")))
+void
+deintAVX512(const int8_t *src, unsigned nch, size_t nelms, D * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	size_t i = 0;
+	if ( 2 == nch ) {
+		__m512d s0 = _mm512_set1_pd( scl[0] ), o0 = _mm512_set1_pd( off[0] );
+		__m512d s1 = _mm512_set1_pd( scl[1] ), o1 = _mm512_set1_pd( off[1] );
+		AccAVX512 a0, a1;
+		init( &a0 );
+		init( &a1 );
+		// 16-bit shifts on 512-bit vectors need AVX512BW; de-interleave
+		// with AVX2 and widen to 16 x int32.
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + 2*i ) );
+			if ( dst[0] ) {
+				store16( dst[0] + i, _mm512_cvtepi16_epi32( _mm256_srai_epi16( _mm256_slli_epi16( x, 8 ), 8 ) ), s0, o0, &a0 );
+			}
+			if ( dst[1] ) {
+				store16( dst[1] + i, _mm512_cvtepi16_epi32( _mm256_srai_epi16( x, 8 ) ), s1, o1, &a1 );
+			}
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				flush( &a1, &stats[1] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+		flush( &a1, &stats[1] );
+	} else if ( 1 == nch && dst[0] ) {
+		__m512d s0 = _mm512_set1_pd( scl[0] ), o0 = _mm512_set1_pd( off[0] );
+		AccAVX512 a0;
+		init( &a0 );
+		for ( size_t n = 0; i + 16 <= nelms; i += 16 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+			store16( dst[0] + i, _mm512_cvtepi8_epi32( x ), s0, o0, &a0 );
+			if ( ++n == FLUSH_ITERATIONS/2 ) {
+				flush( &a0, &stats[0] );
+				n = 0;
+			}
+		}
+		flush( &a0, &stats[0] );
+	}
+	deintScalar( src, nch, i, nelms, dst, scl, off, stats );
+}
+
+// load four complex numbers
+__attribute__((target("avx2")))
+static inline void
+loadC4(const double (*s)[2], __m256d *v0, __m256d *v1)
+{
+	*v0 = _mm256_loadu_pd( s[0] );
+	*v1 = _mm256_loadu_pd( s[2] );
+}
+
+__attribute__((target("avx2")))
+static inline void
+loadC4(const float (*s)[2], __m256d *v0, __m256d *v1)
+{
+	__m256 x = _mm256_loadu_ps( s[0] );
+	*v0 = _mm256_cvtps_pd( _mm256_castps256_ps128( x ) );
+	*v1 = _mm256_cvtps_pd( _mm256_extractf128_ps( x, 1 ) );
+}
+
+// same algorithm as the scalar logModFast()
+template <typename D>
+__attribute__((target("avx2")))
+void
+logModFastAVX2(const D (*src)[2], size_t n, D *dst)
+{
+	const __m256i mmsk  = _mm256_set1_epi64x( MANT_MSK );
+	const __m256i mone  = _mm256_set1_epi64x( EXP_ONE  );
+	// int64 -> double: or into the mantissa of 2^52 and subtract 2^52
+	const __m256i mcvt  = _mm256_set1_epi64x( 0x4330000000000000ULL );
+	const __m256d dcvt  = _mm256_set1_pd( 4503599627370496.0 + 1023.0 );
+	const __m256d sqrt2 = _mm256_set1_pd( M_SQRT2 );
+	const __m256d one   = _mm256_set1_pd( 1.0 );
+	const __m256d half  = _mm256_set1_pd( 0.5 );
+	const __m256d zero  = _mm256_setzero_pd();
+	const __m256d ninf  = _mm256_set1_pd( -HUGE_VAL );
+	const __m256d c3    = _mm256_set1_pd( 1.0/3.0 );
+	const __m256d c5    = _mm256_set1_pd( 1.0/5.0 );
+	const __m256d c7    = _mm256_set1_pd( 1.0/7.0 );
+	const __m256d lg2   = _mm256_set1_pd( 0.5*M_LN2/M_LN10 );
+	const __m256d lge   = _mm256_set1_pd( M_LOG10E );
+	size_t i = 0;
+	for ( ; i + 4 <= n; i += 4 ) {
+		__m256d v0, v1;
+		loadC4( src + i, &v0, &v1 );
+		// hadd yields p0, p2, p1, p3
+		__m256d p  = _mm256_hadd_pd( _mm256_mul_pd( v0, v0 ), _mm256_mul_pd( v1, v1 ) );
+		p          = _mm256_permute4x64_pd( p, 0xd8 );
+		__m256i b  = _mm256_castpd_si256( p );
+		__m256d e  = _mm256_sub_pd( _mm256_castsi256_pd( _mm256_or_si256( _mm256_srli_epi64( b, 52 ), mcvt ) ), dcvt );
+		__m256d m  = _mm256_castsi256_pd( _mm256_or_si256( _mm256_and_si256( b, mmsk ), mone ) );
+		__m256d bg = _mm256_cmp_pd( m, sqrt2, _CMP_GT_OQ );
+		m          = _mm256_blendv_pd( m, _mm256_mul_pd( m, half ), bg );
+		e          = _mm256_add_pd( e, _mm256_and_pd( bg, one ) );
+		__m256d t  = _mm256_div_pd( _mm256_sub_pd( m, one ), _mm256_add_pd( m, one ) );
+		__m256d t2 = _mm256_mul_pd( t, t );
+		__m256d l  = _mm256_add_pd( c5, _mm256_mul_pd( t2, c7 ) );
+		l          = _mm256_add_pd( c3, _mm256_mul_pd( t2, l ) );
+		l          = _mm256_add_pd( one, _mm256_mul_pd( t2, l ) );
+		// 0.5 * 2 * t * l
+		l          = _mm256_mul_pd( t, l );
+		__m256d r  = _mm256_add_pd( _mm256_mul_pd( e, lg2 ), _mm256_mul_pd( l, lge ) );
+		r          = _mm256_blendv_pd( r, ninf, _mm256_cmp_pd( p, zero, _CMP_EQ_OQ ) );
+		storeOut( dst + i, r );
+	}
+	logModFast( src + i, n - i, dst + i );
+}
+
+__attribute__((target("avx2")))
+static inline __m256d
+loadD4(const double *s)
+{
+	return _mm256_loadu_pd( s );
+}
+
+__attribute__((target("avx2")))
+static inline __m256d
+loadD4(const float *s)
+{
+	return _mm256_cvtps_pd( _mm_loadu_ps( s ) );
+}
+
+// same operations as binScalar(); the clamped values are integers
+// in [0, nbins - 1] so the truncating conversion is exact.
+template <typename D>
+__attribute__((target("avx2")))
+void
+binAVX2(const D *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst)
+{
+	const __m256d vlo  = _mm256_set1_pd( lo );
+	const __m256d vscl = _mm256_set1_pd( scl );
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d top  = _mm256_set1_pd( static_cast<double>( nbins - 1 ) );
+	size_t i = 0;
+	for ( ; i + 8 <= n; i += 8 ) {
+		__m256d v0 = _mm256_floor_pd( _mm256_mul_pd( _mm256_sub_pd( loadD4( src + i + 0 ), vlo ), vscl ) );
+		__m256d v1 = _mm256_floor_pd( _mm256_mul_pd( _mm256_sub_pd( loadD4( src + i + 4 ), vlo ), vscl ) );
+		v0         = _mm256_min_pd( _mm256_max_pd( v0, zero ), top );
+		v1         = _mm256_min_pd( _mm256_max_pd( v1, zero ), top );
+		__m256i r  = _mm256_set_m128i( _mm256_cvttpd_epi32( v1 ), _mm256_cvttpd_epi32( v0 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ), r );
+	}
+	binScalar( src + i, n - i, lo, scl, nbins, dst + i );
+}
+
+#endif
+
+// kernels for one output type
+template <typename D>
+struct Kernels {
+	DeintFn<int8_t,  D> deint8;
+	DeintFn<int16_t, D> deint16;
+	LogModFn<D>         logModFast;
+	BinFn<D>            bin;
+};
+
+struct Impl {
+	const char       *name;
+	bool            (*supported)();
+	Kernels<double>   dbl;
+	Kernels<float>    flt;
+};
+
+#define DSPK_KERNELS(deint, logMod, bin, D) \
+	{ deint<D>, deint<D>, logMod<D>, bin<D> }
+
+#define DSPK_IMPL(name, supported, deint, logMod, bin) \
+	{ name, supported, DSPK_KERNELS(deint, logMod, bin, double), DSPK_KERNELS(deint, logMod, bin, float) }
+
+// ordered by preference (best last)
+const Impl impls[] = {
+	{ "scalar",
+	  [](){ return true; },
+	  { deintScalar<int8_t, double>, deintScalar<int16_t, double>, logModFast<double>, binScalar<double> },
+	  { deintScalar<int8_t, float>,  deintScalar<int16_t, float>,  logModFast<float>,  binScalar<float>  } },
+#ifdef DSPK_X86
+	// SSE2 has no rounding instruction (SSE4.1)
+	DSPK_IMPL( "sse2",   [](){ return !! __builtin_cpu_supports( "sse2" ); },    deintSSE2,   logModFast,     binScalar ),
+	DSPK_IMPL( "avx2",   [](){ return !! __builtin_cpu_supports( "avx2" ); },    deintAVX2,   logModFastAVX2, binAVX2   ),
+	DSPK_IMPL( "avx512", [](){ return !! __builtin_cpu_supports( "avx512f" ); }, deintAVX512, logModFastAVX2, binAVX2   ),
+#endif
+};
+
+#undef DSPK_IMPL
+#undef DSPK_KERNELS
+
+const Impl *
+bestImpl()
+{
+#ifdef DSPK_X86
+	__builtin_cpu_init();
+#endif
+	const Impl *rv = &impls[0];
+	for ( auto &impl : impls ) {
+		if ( impl.supported() ) {
+			rv = &impl;
+		}
+	}
+	return rv;
+}
+
+std::atomic<const Impl *> &
+current()
+{
+	static std::atomic<const Impl *> impl( bestImpl() );
+	return impl;
+}
+
+};
+
+namespace DSPKernels {
+
+static void
+resetStats(unsigned nch, RawStats stats[])
+{
+	for ( unsigned ch = 0; ch < nch; ++ch ) {
+		stats[ch].reset();
+	}
+}
+
+void
+deinterleave(const int8_t  *src, unsigned nch, size_t nelms, double * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	resetStats( nch, stats );
+	current().load( std::memory_order_relaxed )->dbl.deint8( src, nch, nelms, dst, scl, off, stats );
+}
+
+void
+deinterleave(const int16_t *src, unsigned nch, size_t nelms, double * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	resetStats( nch, stats );
+	current().load( std::memory_order_relaxed )->dbl.deint16( src, nch, nelms, dst, scl, off, stats );
+}
+
+void
+deinterleave(const int8_t  *src, unsigned nch, size_t nelms, float  * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	resetStats( nch, stats );
+	current().load( std::memory_order_relaxed )->flt.deint8( src, nch, nelms, dst, scl, off, stats );
+}
+
+void
+deinterleave(const int16_t *src, unsigned nch, size_t nelms, float  * const dst[], const double scl[], const double off[], RawStats stats[])
+{
+	resetStats( nch, stats );
+	current().load( std::memory_order_relaxed )->flt.deint16( src, nch, nelms, dst, scl, off, stats );
+}
+
+void
+logModulus(const double (*src)[2], size_t n, double *dst, bool fast)
+{
+	if ( fast ) {
+		current().load( std::memory_order_relaxed )->dbl.logModFast( src, n, dst );
+	} else {
+		logModExact( src, n, dst );
+	}
+}
+
+void
+logModulus(const float  (*src)[2], size_t n, float  *dst, bool fast)
+{
+	if ( fast ) {
+		current().load( std::memory_order_relaxed )->flt.logModFast( src, n, dst );
+	} else {
+		logModExact( src, n, dst );
+	}
+}
+
+void
+binSamples(const double *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst)
+{
+	current().load( std::memory_order_relaxed )->dbl.bin( src, n, lo, scl, nbins, dst );
+}
+
+void
+binSamples(const float  *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst)
+{
+	current().load( std::memory_order_relaxed )->flt.bin( src, n, lo, scl, nbins, dst );
+}
+
+const char *
+getISA()
+{
+	return current().load()->name;
+}
+
+bool
+setISA(const char *isa)
+{
+	for ( auto &impl : impls ) {
+		if ( 0 == strcmp( impl.name, isa ) ) {
+			if ( ! impl.supported() ) {
+				return false;
+			}
+			current().store( &impl );
+			return true;
+		}
+	}
+	return false;
+}
+
+};
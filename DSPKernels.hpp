@@ -0,0 +1,124 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Hot-path processing kernels. Vectorized variants are selected
+// at run-time based on the capabilities of the CPU; all variants
+// produce results which are bit-identical to the scalar code (except
+// for the approximations which must be requested explicitly).
+namespace DSPKernels {
+
+	// exact statistics of raw ADC samples
+	struct RawStats {
+		int64_t   sum;
+		int64_t   sumSq;
+		int32_t   min;
+		int32_t   max;
+
+		void
+		reset()
+		{
+			sum   = 0;
+			sumSq = 0;
+			min   = INT32_MAX;
+			max   = INT32_MIN;
+		}
+
+		void
+		merge(const RawStats &o)
+		{
+			sum   += o.sum;
+			sumSq += o.sumSq;
+			if ( o.min < min ) {
+				min = o.min;
+			}
+			if ( o.max > max ) {
+				max = o.max;
+			}
+		}
+	};
+
+	// de-interleave 'nelms' samples of 'nch' channels starting at 'src':
+	//
+	//   dst[ch][i] = scl[ch] * ( (double)src[i*nch + ch] - off[ch] )
+	//
+	// and compute statistics of the raw samples of each channel in the
+	// same pass; 'stats[ch]' is overwritten. The float variants compute
+	// in double precision and round the result.
+	// Channels with a NULL 'dst[ch]' are skipped ('stats[ch]' is only
+	// reset).
+	void
+	deinterleave(const int8_t  *src, unsigned nch, size_t nelms, double * const dst[], const double scl[], const double off[], RawStats stats[]);
+
+	void
+	deinterleave(const int16_t *src, unsigned nch, size_t nelms, double * const dst[], const double scl[], const double off[], RawStats stats[]);
+
+	void
+	deinterleave(const int8_t  *src, unsigned nch, size_t nelms, float  * const dst[], const double scl[], const double off[], RawStats stats[]);
+
+	void
+	deinterleave(const int16_t *src, unsigned nch, size_t nelms, float  * const dst[], const double scl[], const double off[], RawStats stats[]);
+
+	// logarithm of the modulus of 'n' complex numbers (re, im):
+	//
+	//   dst[i] = log10( |src[i]| ) = 0.5*log10( re^2 + im^2 )
+	//
+	// If 'fast' is set then a vectorized approximation is used; its
+	// error is below 1E-6dB ( 20*log10( |src[i]| ) ) for all normal
+	// numbers; zero yields -HUGE_VAL (verified by dspKernelsTest).
+	void
+	logModulus(const double (*src)[2], size_t n, double *dst, bool fast);
+
+	void
+	logModulus(const float  (*src)[2], size_t n, float  *dst, bool fast);
+
+	// vertical histogram bin of each of 'n' samples:
+	//
+	//   dst[i] = min( max( floor( ( (double)src[i] - lo ) * scl ), 0 ), nbins - 1 )
+	//
+	// i.e., samples outside of the range are assigned to the first
+	// or last bin. 'nbins' must not exceed INT32_MAX; the samples
+	// must not be NaN.
+	void
+	binSamples(const double *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst);
+
+	void
+	binSamples(const float  *src, size_t n, double lo, double scl, uint32_t nbins, uint32_t *dst);
+
+	// name of the implementation currently in use ("scalar", "sse2",
+	// "avx2", "avx512")
+	const char *
+	getISA();
+
+	// force a particular implementation (e.g., for benchmarking);
+	// returns false if 'isa' is not supported by this CPU.
+	bool
+	setISA(const char *isa);
+};
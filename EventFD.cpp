@@ -0,0 +1,81 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <EventFD.hpp>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <errno.h>
+#include <system_error>
+
+EventFD::EventFD()
+{
+	if ( (fd_ = ::eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC )) < 0 ) {
+		throw std::system_error( errno, std::system_category(), __func__ );
+	}
+}
+
+EventFD::~EventFD()
+{
+	close( fd_ );
+}
+
+void
+EventFD::signal()
+{
+	uint64_t val = 1;
+	// may only fail (EAGAIN) if the counter is about to overflow
+	// in which case the descriptor is readable anyways
+	if ( ::write( fd_, &val, sizeof(val) ) != sizeof(val) && EAGAIN != errno ) {
+		throw std::system_error( errno, std::system_category(), __func__ );
+	}
+}
+
+bool
+EventFD::clear()
+{
+	uint64_t val;
+	if ( ::read( fd_, &val, sizeof(val) ) != sizeof(val) ) {
+		if ( EAGAIN == errno ) {
+			return false;
+		}
+		throw std::system_error( errno, std::system_category(), __func__ );
+	}
+	return true;
+}
+
+void
+EventFD::wait()
+{
+	struct pollfd pfd;
+	pfd.fd     = fd_;
+	pfd.events = POLLIN;
+	while ( ::poll( &pfd, 1, -1 ) < 0 ) {
+		if ( EINTR != errno ) {
+			throw std::system_error( errno, std::system_category(), __func__ );
+		}
+	}
+}
@@ -0,0 +1,61 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Thin wrapper around a (non-blocking) linux eventfd; used to
+// wake up a thread which poll()s on other descriptors, too.
+class EventFD {
+private:
+	int	fd_;
+
+	EventFD(const EventFD &)    = delete;
+
+	EventFD &
+	operator=(const EventFD &)  = delete;
+
+public:
+	EventFD();
+
+	// allow for select/poll
+	virtual int  getFD()
+	{
+		return fd_;
+	}
+
+	// increment the counter; makes the descriptor readable
+	virtual void signal();
+
+	// reset the counter; returns false if it was zero already
+	virtual bool clear();
+
+	// block until the descriptor is readable (does not clear)
+	virtual void wait();
+
+	virtual ~EventFD();
+};
@@ -0,0 +1,148 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stddef.h>
+#include <fftw3.h>
+
+// Map the sample type to the matching fftw API (fftw_* for double,
+// fftwf_* for float); only what we use is wrapped.
+template <typename T> struct FFTWTraits;
+
+template <>
+struct FFTWTraits<double> {
+	typedef fftw_complex Complex;
+	typedef fftw_plan    Plan;
+
+	constexpr static const char *WISDOM_FILE = "scope_fftw_wisdom.bin";
+
+	static double *
+	allocReal(size_t n)
+	{
+		return fftw_alloc_real( n );
+	}
+
+	static Complex *
+	allocComplex(size_t n)
+	{
+		return fftw_alloc_complex( n );
+	}
+
+	static void
+	free(void *p)
+	{
+		fftw_free( p );
+	}
+
+	static Plan
+	planR2C(int n, double *in, Complex *out, unsigned flags)
+	{
+		return fftw_plan_dft_r2c_1d( n, in, out, flags );
+	}
+
+	// new-array interface
+	static void
+	executeR2C(const Plan plan, double *in, Complex *out)
+	{
+		fftw_execute_dft_r2c( plan, in, out );
+	}
+
+	static void
+	destroyPlan(Plan plan)
+	{
+		fftw_destroy_plan( plan );
+	}
+
+	static int
+	importWisdom(const char *fnam)
+	{
+		return fftw_import_wisdom_from_filename( fnam );
+	}
+
+	static int
+	exportWisdom(const char *fnam)
+	{
+		return fftw_export_wisdom_to_filename( fnam );
+	}
+};
+
+template <>
+struct FFTWTraits<float> {
+	typedef fftwf_complex Complex;
+	typedef fftwf_plan    Plan;
+
+	constexpr static const char *WISDOM_FILE = "scope_fftwf_wisdom.bin";
+
+	static float *
+	allocReal(size_t n)
+	{
+		return fftwf_alloc_real( n );
+	}
+
+	static Complex *
+	allocComplex(size_t n)
+	{
+		return fftwf_alloc_complex( n );
+	}
+
+	static void
+	free(void *p)
+	{
+		fftwf_free( p );
+	}
+
+	static Plan
+	planR2C(int n, float *in, Complex *out, unsigned flags)
+	{
+		return fftwf_plan_dft_r2c_1d( n, in, out, flags );
+	}
+
+	// new-array interface
+	static void
+	executeR2C(const Plan plan, float *in, Complex *out)
+	{
+		fftwf_execute_dft_r2c( plan, in, out );
+	}
+
+	static void
+	destroyPlan(Plan plan)
+	{
+		fftwf_destroy_plan( plan );
+	}
+
+	static int
+	importWisdom(const char *fnam)
+	{
+		return fftwf_import_wisdom_from_filename( fnam );
+	}
+
+	static int
+	exportWisdom(const char *fnam)
+	{
+		return fftwf_export_wisdom_to_filename( fnam );
+	}
+};
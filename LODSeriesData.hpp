@@ -0,0 +1,138 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <qwt_series_data.h>
+
+#include <MinMaxLOD.hpp>
+#include <LinearAbscissa.hpp>
+
+// Series serving a long record at screen resolution: QWT passes the
+// visible (zoom) rectangle to setRectOfInterest() before drawing; the
+// samples in the visible range are then reduced to their min/max
+// envelope (one bin per pixel or so) using the pyramid that was built
+// by the DSP stage. Replot time thus depends on the canvas width rather
+// than on the record length. If there are only a few samples per pixel
+// the raw samples are served.
+template <typename TY>
+class LODSeriesData : public QwtSeriesData<QPointF> {
+private:
+	LinearAbscissa         x_;
+	MinMaxLOD<TY>          lod_;
+	unsigned               pixels_;
+	std::vector<QPointF>   pts_;
+
+	// first index with x >= xv
+	unsigned
+	lowerIndex(double xv) const
+	{
+		return x_.lowerIndex( xv, lod_.size() );
+	}
+
+	void
+	update(unsigned i0, unsigned i1)
+	{
+		const TY *y = lod_.samples();
+		pts_.clear();
+		if ( i1 <= i0 ) {
+			return;
+		}
+		if ( i1 - i0 <= RAW_LIMIT * pixels_ ) {
+			for ( unsigned i = i0; i < i1; ++i ) {
+				pts_.emplace_back( x_[i], y[i] );
+			}
+			return;
+		}
+		bool odd = false;
+		lod_.envelope( i0, i1, pixels_, [this, &odd](unsigned i, TY mn, TY mx) {
+			// alternate the order so that consecutive bins are
+			// connected min-to-min and max-to-max
+			pts_.emplace_back( x_[i], odd ? mx : mn );
+			pts_.emplace_back( x_[i], odd ? mn : mx );
+			odd = ! odd;
+		} );
+	}
+
+public:
+	// serve raw samples if there are no more than this many per pixel
+	constexpr static unsigned RAW_LIMIT = 2;
+
+	LODSeriesData(const LinearAbscissa &x, const MinMaxLOD<TY> &lod, unsigned pixels)
+	: x_      ( x                       ),
+	  lod_    ( lod                     ),
+	  pixels_ ( std::max( pixels, 1U )  )
+	{
+		update( 0, lod_.size() );
+	}
+
+	virtual void
+	setRectOfInterest(const QRectF &r) override
+	{
+		unsigned n  = lod_.size();
+		if ( 0 == n ) {
+			return;
+		}
+		// include one sample on either side so the curve
+		// extends to the edges of the canvas
+		unsigned i0 = lowerIndex( r.left()  );
+		unsigned i1 = lowerIndex( r.right() ) + 1;
+		i0 = i0 > 0 ? i0 - 1 : 0;
+		i1 = std::min( i1, n );
+		update( i0, i1 );
+	}
+
+	virtual size_t
+	size() const override
+	{
+		return pts_.size();
+	}
+
+	virtual QPointF
+	sample(size_t i) const override
+	{
+		return pts_[i];
+	}
+
+	virtual QRectF
+	boundingRect() const override
+	{
+		if ( cachedBoundingRect.width() < 0.0 ) {
+			unsigned n = lod_.size();
+			if ( 0 == n ) {
+				cachedBoundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 );
+			} else {
+				TY mn, mx;
+				lod_.range( &mn, &mx );
+				cachedBoundingRect = QRectF( x_[0], mn, x_[n - 1] - x_[0], mx - mn );
+			}
+		}
+		return cachedBoundingRect;
+	}
+};
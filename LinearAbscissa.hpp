@@ -0,0 +1,63 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stddef.h>
+#include <math.h>
+
+// Equidistant abscissa x_i = i*scale + offset which is computed on
+// demand rather than stored in an array. Can be used wherever an array
+// of abscissae is indexed.
+class LinearAbscissa {
+private:
+	double scale_;
+	double offset_;
+
+public:
+	LinearAbscissa(double scale = 1.0, double offset = 0.0)
+	: scale_ ( scale  ),
+	  offset_( offset )
+	{
+	}
+
+	double
+	operator[](size_t i) const
+	{
+		return (double)i * scale_ + offset_;
+	}
+
+	// first index 'i' with x_i >= x (scale > 0), clipped to [0, n]
+	size_t
+	lowerIndex(double x, size_t n) const
+	{
+		double i = ceil( (x - offset_)/scale_ );
+		if ( ! (i > 0.0) ) {
+			return 0;
+		}
+		return i < (double)n ? (size_t)i : n;
+	}
+};
@@ -0,0 +1,178 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+
+// Level-of-detail pyramid of a waveform: level 0 holds the minimum
+// and maximum of every BASE consecutive samples, level k + 1 combines
+// FACTOR blocks of level k. The envelope of any index range can then
+// be produced at (roughly) a requested number of bins in time that is
+// independent of the record length; the extrema - and hence glitches -
+// are preserved.
+template <typename T>
+class MinMaxLOD {
+public:
+	constexpr static unsigned BASE   = 8;
+	constexpr static unsigned FACTOR = 4;
+
+private:
+	const T   *y_;
+	const T   *lod_;
+	unsigned   n_;
+
+	static unsigned
+	nblks(unsigned n, size_t bs)
+	{
+		return (unsigned)( (n + bs - 1) / bs );
+	}
+
+public:
+	MinMaxLOD(const T *y = nullptr, const T *lod = nullptr, unsigned n = 0)
+	: y_  ( y   ),
+	  lod_( lod ),
+	  n_  ( n   )
+	{
+	}
+
+	// elements of T needed for the pyramid of 'n' samples
+	static size_t
+	storage(unsigned n)
+	{
+		size_t   sz = 0;
+		size_t   bs = BASE;
+		unsigned nb;
+		do {
+			nb  = nblks( n, bs );
+			sz += 2*nb;
+			bs *= FACTOR;
+		} while ( nb > 1 );
+		return sz;
+	}
+
+	static void
+	build(const T *y, unsigned n, T *lod)
+	{
+		if ( 0 == n ) {
+			return;
+		}
+		// level 0 from the samples
+		T        *dp = lod;
+		for ( unsigned i = 0; i < n; i += BASE ) {
+			unsigned e  = std::min( i + BASE, n );
+			T        mn = y[i];
+			T        mx = y[i];
+			for ( unsigned j = i + 1; j < e; ++j ) {
+				mn = y[j] < mn ? y[j] : mn;
+				mx = y[j] > mx ? y[j] : mx;
+			}
+			*dp++ = mn;
+			*dp++ = mx;
+		}
+		// higher levels from the one below
+		const T  *sp = lod;
+		unsigned  nb = nblks( n, BASE );
+		while ( nb > 1 ) {
+			for ( unsigned i = 0; i < nb; i += FACTOR ) {
+				unsigned e  = std::min( i + FACTOR, nb );
+				T        mn = sp[2*i    ];
+				T        mx = sp[2*i + 1];
+				for ( unsigned j = i + 1; j < e; ++j ) {
+					mn = sp[2*j    ] < mn ? sp[2*j    ] : mn;
+					mx = sp[2*j + 1] > mx ? sp[2*j + 1] : mx;
+				}
+				*dp++ = mn;
+				*dp++ = mx;
+			}
+			sp += 2*nb;
+			nb  = nblks( nb, FACTOR );
+		}
+	}
+
+	unsigned
+	size() const
+	{
+		return n_;
+	}
+
+	const T *
+	samples() const
+	{
+		return y_;
+	}
+
+	// overall extrema (from the top level)
+	void
+	range(T *mn, T *mx) const
+	{
+		const T *lv = lod_;
+		size_t   bs = BASE;
+		unsigned nb;
+		while ( (nb = nblks( n_, bs )) > 1 ) {
+			lv += 2*nb;
+			bs *= FACTOR;
+		}
+		*mn = lv[0];
+		*mx = lv[1];
+	}
+
+	// Envelope of samples [i0, i1) in about 'nbins' (at least) bins
+	// made of whole blocks of the coarsest suitable level; calls
+	// out(first_index_of_bin, min, max) for each bin.
+	template <typename F>
+	void
+	envelope(unsigned i0, unsigned i1, unsigned nbins, F out) const
+	{
+		i1 = std::min( i1, n_ );
+		if ( i0 >= i1 || 0 == nbins ) {
+			return;
+		}
+		size_t   spb = (i1 - i0)/nbins;
+		size_t   bs  = BASE;
+		const T *lv  = lod_;
+		unsigned nb  = nblks( n_, bs );
+		while ( nb > 1 && bs*FACTOR <= spb ) {
+			lv += 2*nb;
+			bs *= FACTOR;
+			nb  = nblks( n_, bs );
+		}
+		unsigned b0 = (unsigned)( i0/bs );
+		unsigned b1 = nblks( i1, bs );
+		unsigned g  = std::max( 1U, (b1 - b0)/nbins );
+		for ( unsigned b = b0; b < b1; b += g ) {
+			unsigned e  = std::min( b + g, b1 );
+			T        mn = lv[2*b    ];
+			T        mx = lv[2*b + 1];
+			for ( unsigned j = b + 1; j < e; ++j ) {
+				mn = lv[2*j    ] < mn ? lv[2*j    ] : mn;
+				mx = lv[2*j + 1] > mx ? lv[2*j + 1] : mx;
+			}
+			out( (unsigned)( b*bs ), mn, mx );
+		}
+	}
+};
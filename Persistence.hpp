@@ -0,0 +1,191 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+
+#include <DSPKernels.hpp>
+
+// State of one channel's histogram as handed to the GUI
+struct PersistenceSnapshot {
+	std::vector<float> hits;         // xbins columns of ybins each
+	uint64_t           frames  {0};  // accumulated since the last reset
+	size_t             nelms   {0};  // samples per frame
+	float              peak    {0.0};
+};
+
+// "Digital phosphor": a 2D histogram (time x amplitude) of the
+// time-domain samples of every channel. The DSP stage adds each
+// processed frame; the hits of older frames fade by 'decay' per
+// frame (1.0: infinite persistence). The GUI takes snapshots to
+// render an intensity-graded image.
+// Accumulation of different channels may proceed concurrently.
+template <typename T>
+class Persistence {
+private:
+	struct Plane {
+		std::mutex            mtx;
+		std::vector<float>    hits;
+		// vertical bin of every sample (scratch)
+		std::vector<uint32_t> idx;
+		uint64_t              frames {0};
+		size_t                nelms  {0};
+		unsigned              epoch  {0};
+	};
+
+	unsigned                  nch_;
+	unsigned                  xbins_;
+	unsigned                  ybins_;
+	double                    yLo_;
+	double                    yHi_;
+	double                    yScl_;
+	std::atomic<float>        decay_;
+	std::unique_ptr<Plane[]>  planes_;
+
+	Plane &
+	plane(unsigned ch)
+	{
+		if ( ch >= nch_ ) {
+			throw std::invalid_argument( "Persistence: invalid channel" );
+		}
+		return planes_[ch];
+	}
+
+public:
+	// samples in [yLo, yHi] are spread over 'ybins'; samples outside
+	// of this range hit the first/last bin.
+	Persistence(unsigned nch, unsigned xbins, unsigned ybins, double yLo, double yHi, double decay)
+	: nch_    ( nch    ),
+	  xbins_  ( xbins  ),
+	  ybins_  ( ybins  ),
+	  yLo_    ( yLo    ),
+	  yHi_    ( yHi    ),
+	  yScl_   ( (double)ybins/(yHi - yLo) ),
+	  decay_  ( decay  ),
+	  planes_ ( new Plane[nch] )
+	{
+		if ( 0 == xbins || 0 == ybins || ybins > INT32_MAX || ! (yHi > yLo) ) {
+			throw std::invalid_argument( "Persistence: invalid geometry" );
+		}
+		for ( unsigned ch = 0; ch < nch_; ++ch ) {
+			planes_[ch].hits.resize( (size_t)xbins_ * ybins_ );
+		}
+	}
+
+	unsigned getNumChannels() const { return nch_;   }
+	unsigned getXBins()       const { return xbins_; }
+	unsigned getYBins()       const { return ybins_; }
+	double   getYLo()         const { return yLo_;   }
+	double   getYHi()         const { return yHi_;   }
+
+	double
+	getDecay() const
+	{
+		return decay_.load( std::memory_order_relaxed );
+	}
+
+	void
+	setDecay(double decay)
+	{
+		decay_.store( decay, std::memory_order_relaxed );
+	}
+
+	// add a frame of 'n' samples to the histogram of channel 'ch'.
+	// Sample 'i' goes into column i*xbins/n. The histogram is
+	// reset if 'epoch' (e.g., the buffer sync; changes with the
+	// acquisition parameters) differs from the last frame's.
+	void
+	accumulate(unsigned ch, const T *y, size_t n, unsigned epoch)
+	{
+		Plane &p = plane( ch );
+		std::lock_guard<std::mutex> lg( p.mtx );
+		if ( epoch != p.epoch || n != p.nelms ) {
+			std::fill( p.hits.begin(), p.hits.end(), 0.0f );
+			p.frames = 0;
+			p.epoch  = epoch;
+			p.nelms  = n;
+		} else {
+			float decay = decay_.load( std::memory_order_relaxed );
+			if ( decay < 1.0f ) {
+				for ( auto &h : p.hits ) {
+					h *= decay;
+				}
+			}
+		}
+		if ( p.idx.size() < n ) {
+			p.idx.resize( n );
+		}
+		DSPKernels::binSamples( y, n, yLo_, yScl_, ybins_, p.idx.data() );
+		// there is no vectorized scatter-add; increment column by column
+		size_t i = 0;
+		for ( unsigned c = 0; c < xbins_; ++c ) {
+			size_t          e   = ( (uint64_t)(c + 1) * n ) / xbins_;
+			float          *col = &p.hits[ (size_t)c * ybins_ ];
+			const uint32_t *idx = p.idx.data();
+			for ( ; i < e; ++i ) {
+				col[ idx[i] ] += 1.0f;
+			}
+		}
+		p.frames++;
+	}
+
+	// copy the state of channel 'ch'; returns false if nothing
+	// was accumulated yet.
+	bool
+	snapshot(unsigned ch, PersistenceSnapshot *s)
+	{
+		Plane &p = plane( ch );
+		{
+		std::lock_guard<std::mutex> lg( p.mtx );
+		s->frames = p.frames;
+		s->nelms  = p.nelms;
+		if ( 0 == p.frames ) {
+			return false;
+		}
+		s->hits   = p.hits;
+		}
+		s->peak = *std::max_element( s->hits.begin(), s->hits.end() );
+		return true;
+	}
+
+	void
+	clear()
+	{
+		for ( unsigned ch = 0; ch < nch_; ++ch ) {
+			std::lock_guard<std::mutex> lg( planes_[ch].mtx );
+			std::fill( planes_[ch].hits.begin(), planes_[ch].hits.end(), 0.0f );
+			planes_[ch].frames = 0;
+		}
+	}
+};
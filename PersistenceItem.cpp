@@ -0,0 +1,76 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <PersistenceItem.hpp>
+
+#include <QPainter>
+#include <math.h>
+#include <algorithm>
+
+PersistenceItem::PersistenceItem(unsigned ch, const QColor &color)
+: ch_    ( ch    ),
+  color_ ( color )
+{
+	// underneath the curves
+	setZ( 10.0 );
+	setRenderHint( QwtPlotItem::RenderAntialiased, false );
+}
+
+void
+PersistenceItem::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+{
+	if ( ! persist_ || ! persist_->snapshot( ch_, &snap_ ) || ! ( snap_.peak > 0.0f ) ) {
+		return;
+	}
+	unsigned xb = persist_->getXBins();
+	unsigned yb = persist_->getYBins();
+	if ( img_.width() != (int)xb || img_.height() != (int)yb ) {
+		img_ = QImage( xb, yb, QImage::Format_ARGB32_Premultiplied );
+	}
+	// logarithmic intensity so that rare events remain visible
+	float   nrm    = 255.0f/log1pf( snap_.peak );
+	int     r      = color_.red();
+	int     g      = color_.green();
+	int     b      = color_.blue();
+	QRgb   *px     = reinterpret_cast<QRgb*>( img_.bits() );
+	size_t  stride = img_.bytesPerLine()/sizeof(QRgb);
+	for ( unsigned x = 0; x < xb; ++x ) {
+		const float *col = &snap_.hits[ (size_t)x * yb ];
+		// image row 0 is the top (highest bin)
+		QRgb        *p   = px + (size_t)(yb - 1) * stride + x;
+		for ( unsigned y = 0; y < yb; ++y, p -= stride ) {
+			int a = std::min( (int)( log1pf( col[y] ) * nrm ), 255 );
+			*p    = qRgba( r*a/255, g*a/255, b*a/255, a );
+		}
+	}
+	// column 'c' holds samples [c*n/xbins, (c+1)*n/xbins)
+	QRectF tgt( QPointF( xMap.transform( -0.5 ),                      yMap.transform( persist_->getYHi() ) ),
+	            QPointF( xMap.transform( (double)snap_.nelms - 0.5 ), yMap.transform( persist_->getYLo() ) ) );
+	painter->save();
+	painter->setClipRect( canvasRect );
+	painter->drawImage( tgt.normalized(), img_ );
+	painter->restore();
+}
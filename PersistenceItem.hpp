@@ -0,0 +1,60 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <QColor>
+#include <QImage>
+
+#include <qwt_plot_item.h>
+#include <qwt_scale_map.h>
+
+#include <BufTypes.hpp>
+
+// Plot layer rendering the persistence histogram of one channel
+// as an intensity-graded image (in the channel color) underneath
+// the curves. Draws nothing unless a Persistence is attached.
+class PersistenceItem : public QwtPlotItem {
+private:
+	PersistencePtr                persist_;
+	unsigned                      ch_;
+	QColor                        color_;
+	// draw() is const; cache the buffers
+	mutable PersistenceSnapshot   snap_;
+	mutable QImage                img_;
+
+public:
+	PersistenceItem(unsigned ch, const QColor &color);
+
+	void
+	setPersistence(PersistencePtr p)
+	{
+		persist_ = p;
+	}
+
+	virtual void
+	draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const override;
+};
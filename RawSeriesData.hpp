@@ -0,0 +1,71 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <qwt_series_data.h>
+
+// Like QwtCPointerData (which - depending on the QWT version - only
+// supports double) but for arbitrary (arithmetic) ordinate types;
+// samples are converted to double only when QWT fetches them.
+// TX is anything that can be indexed, e.g., a pointer to an array
+// or a LinearAbscissa.
+template <typename TX, typename TY>
+class RawSeriesData : public QwtSeriesData<QPointF> {
+private:
+	TX          x_;
+	const TY   *y_;
+	size_t      n_;
+
+public:
+	RawSeriesData(TX x, const TY *y, size_t n)
+	: x_( x ),
+	  y_( y ),
+	  n_( n )
+	{
+	}
+
+	virtual size_t
+	size() const override
+	{
+		return n_;
+	}
+
+	virtual QPointF
+	sample(size_t i) const override
+	{
+		return QPointF( x_[i], y_[i] );
+	}
+
+	virtual QRectF
+	boundingRect() const override
+	{
+		if ( cachedBoundingRect.width() < 0.0 ) {
+			cachedBoundingRect = qwtBoundingRect( *this );
+		}
+		return cachedBoundingRect;
+	}
+};
@@ -0,0 +1,107 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+#include <BufTypes.hpp>
+#include <DSPKernels.hpp>
+
+class ReadBufIF {
+public:
+	// copy internal buffer into ADC buffer
+	// (unfortunately QWT only supports samples in row-major
+	// order [independent curves tightly packed] whereas
+	// we receive the data in column-major order which makes
+	// copying unavoidable; also, QWT does not support short int...)
+	// copy a single channel; can be used to parallelize...
+	virtual void copyCh(BufPtr buf, unsigned ch) = 0;
+
+	// copy samples [first, first + nelms) of all channels in a
+	// single pass using vectorized kernels (results are identical
+	// to copyCh); disjoint ranges can be processed in parallel.
+	// Statistics of the raw samples in the range are stored in
+	// stats[ch].
+	virtual void copy(BufPtr buf, unsigned first, unsigned nelms, DSPKernels::RawStats stats[]) = 0;
+
+	virtual ~ReadBufIF() {}
+};
+
+// ReadBuf configures its internal buffer to the actual number of samples
+// which is assumed to never change!
+template <typename T>
+class ReadBuf : public ReadBufIF {
+public:
+	virtual ~ReadBuf()
+	{
+	}
+
+	virtual void
+	copyCh(BufPtr buf, unsigned ch) override
+	{
+		// getData already checks validity of 'ch'
+		BufType::ElementType *dptr            = buf->getData( ch );
+		T                    *sptr            = reinterpret_cast<T*>( buf->getRawData() ) + ch;
+		unsigned              nelms           = buf->getNElms();
+		double                scaleCorrection;
+		double                postGainOffsetTick;
+		unsigned              nch             = buf->getNumChannels();
+		if ( ((nelms - 1)*nch + ch) * sizeof(T) >= buf->getRawSize() ) {
+			throw std::runtime_error("Internal error: buffer overrun");
+		}
+		scaleCorrection    = buf->getScaleCorrection(ch);
+		postGainOffsetTick = buf->scopeParams()->afeParams[ch].postGainOffsetTick;
+
+		while ( nelms > 0 ) {
+			*dptr = scaleCorrection*(static_cast< std::remove_reference<decltype(*dptr)>::type >( *sptr ) - postGainOffsetTick);
+			dptr++;
+			sptr += nch;
+			nelms--;
+		}
+	}
+
+	virtual void
+	copy(BufPtr buf, unsigned first, unsigned nelms, DSPKernels::RawStats stats[]) override
+	{
+		unsigned              nch = buf->getNumChannels();
+		BufType::ElementType *dptr[BufType::MAX_CHANNELS];
+		double                scaleCorrection[BufType::MAX_CHANNELS];
+		double                postGainOffsetTick[BufType::MAX_CHANNELS];
+		if ( first + nelms > buf->getNElms() ) {
+			throw std::runtime_error("Internal error: buffer overrun");
+		}
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			// the kernels skip channels with a NULL destination
+			dptr[ch]               = buf->channelProcessed( ch ) ? buf->getData( ch ) + first : nullptr;
+			scaleCorrection[ch]    = buf->getScaleCorrection(ch);
+			postGainOffsetTick[ch] = buf->scopeParams()->afeParams[ch].postGainOffsetTick;
+		}
+		const T *sptr = reinterpret_cast<T*>( buf->getRawData() ) + first*nch;
+		DSPKernels::deinterleave( sptr, nch, nelms, dptr, scaleCorrection, postGainOffsetTick, stats );
+	}
+};
@@ -28,6 +28,7 @@
 #include <getopt.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <memory>
@@ -35,6 +36,7 @@
 #include <string>
 #include <utility>
 #include <list>
+#include <algorithm>
 
 #include <QApplication>
 #include <QScreen>
@@ -58,6 +60,7 @@
 #include <QStaticText>
 #include <QProgressDialog>
 #include <QDialog>
+#include <QTimer>
 
 #include <qwt_text.h>
 #include <qwt_scale_div.h>
@@ -80,9 +83,15 @@
 #include <KeyPressCallback.hpp>
 #include <ScopeZoomer.hpp>
 #include <ScopePlot.hpp>
+#include <RawSeriesData.hpp>
+#include <LODSeriesData.hpp>
+#include <PersistenceItem.hpp>
+#include <WaterfallWidget.hpp>
+#include <LinearAbscissa.hpp>
 #include <Dispatcher.hpp>
 #include <ScaleXfrm.hpp>
 #include <MessageDialog.hpp>
+#include <StatsDialog.hpp>
 #include <MenuButton.hpp>
 #include <TglButton.hpp>
 #include <ParamValidator.hpp>
@@ -179,13 +188,28 @@ struct ScopeCfg {
 	unsigned    nsamples    { 0          };
 	const char *jsonFnam    { nullptr    };
 	unsigned    versaClkDbg { 0          };
+	unsigned    dspWorkers  { 0          };
+	bool        exactLog    { false      };
+	bool        lazyDSP     { false      };
+	unsigned    asyncDepth  { 0          };
+	double      loopbackHz  { 0.0        };
+	std::vector<SimSignal>
+	            simSignals;
+	double      persistFrames { -1.0     }; // < 0: persistence display off
+	double      displayHz   { -1.0       }; // < 0: default, 0: unlimited
+	unsigned    arenaFlags  { 0          };
+	unsigned    poolDepth   { 0          };
+	ADCBufPoolPolicy
+	            poolPolicy  { ADCBufPoolPolicy::FAIL };
+	unsigned    poolTimeout { 500        }; // ms (BLOCK policy)
+	unsigned    poolBudget  { 1024       }; // MB (GROW policy)
+	RTCfg       rt;
 };
 
-class Scope : public QObject, public Board, public ScaleXfrmCallback, public KeyPressCallback, public ScopeInterface {
+class Scope : public QObject, public Board, public ScaleXfrmCallback, public KeyPressCallback, public ScopeInterface, public ChannelEnableChanged {
 private:
 	constexpr static int                  CHA_IDX    = 0;
 	constexpr static int                  CHB_IDX    = 1;
-	constexpr static int                  NUM_CHNLS  = 2;
 	constexpr static int                  NSMPL_DFLT = 65536;
 	unique_ptr<QMainWindow>               mainWin_;
 	QDockWidget                          *fftDockWid_ { nullptr };
@@ -207,11 +231,9 @@ private:
 	ScopeReader                          *reader_;
 	BufPtr                                curBuf_;
 	// qwt 6.1 does not have setRawSamples(float*,int) :-(
-	double                               *xRange_;
-	double                               *fRange_;
 	unsigned                              nsmpl_;
 	ScopePlot                            *plot_ {nullptr};
-	ScopeReaderCmdPipePtr                 pipe_;
+	ScopeReaderCmdChannelPtr              cmdChnl_;
 	ScopeReaderCmd                        cmd_;
 	vector<double>                        vYScale_;
 	TrigArmMenu                          *trgArm_;
@@ -229,6 +251,27 @@ private:
 	DelayVisualizer                      *delayBar_;
 	ClockGenDialog                       *clockGenDialog_{nullptr};
 	VersaClkDbg                          *clockDbgDialog_{nullptr};
+	StatsDialog                          *statsDialog_{nullptr};
+	// pulls frames from the reader at the display rate
+	QTimer                               *displayTimer_{nullptr};
+	double                                displayHz_;
+	unsigned                              dspWorkers_;
+	bool                                  exactLog_;
+	bool                                  lazyDSP_;
+	unsigned                              asyncDepth_;
+	double                                loopbackHz_;
+	std::vector<SimSignal>                simSignals_;
+	double                                persistFrames_;
+	PersistencePtr                        persist_;
+	vector<PersistenceItem*>              vPersistItems_;
+	WaterfallPtr                          waterfall_;
+	WaterfallWidget                      *waterfallWid_ {nullptr};
+	unsigned                              arenaFlags_;
+	unsigned                              poolDepth_;
+	ADCBufPoolPolicy                      poolPolicy_;
+	unsigned                              poolTimeout_;
+	unsigned                              poolBudget_;
+	RTCfg                                 rtCfg_;
 
 	std::pair<unique_ptr<QHBoxLayout>, QWidget *>
 	mkGainControls( int channel, QColor &color );
@@ -305,7 +348,29 @@ public:
 		saveToDir_ = val;
 	}
 
-	void startReader(unsigned poolDepth = 4);
+	// buffers in flight: read stage, DSP queue, DSP stage, mailbox
+	// and up to two held by the GUI (newData swaps).
+	constexpr static unsigned POOL_DEPTH_DFLT = 6;
+
+	// maximal display refresh rate unless given with -F
+	constexpr static double   DISPLAY_HZ_DFLT = 30.0;
+
+	// frames/s of simulated signals unless given with -l
+	constexpr static double   SIM_RATE_DFLT   = 20.0;
+
+	// geometry of the persistence histograms and the fade
+	// time (frames) unless given with -P
+	constexpr static unsigned PERSIST_XBINS       = 1024;
+	constexpr static unsigned PERSIST_YBINS       = 256;
+	constexpr static double   PERSIST_FRAMES_DFLT = 20.0;
+
+	// spectra in the waterfall history and their width
+	constexpr static unsigned WATERFALL_ROWS      = 512;
+	constexpr static unsigned WATERFALL_COLS      = 1024;
+
+	// 'poolDepth' buffers (0: as configured) are allocated; more
+	// are added for asynchronous acquisition.
+	void startReader(unsigned poolDepth = 0);
 	void stopReader();
 	void clf();
 
@@ -464,6 +529,36 @@ public:
 		}
 	}
 
+	void
+	showStats()
+	{
+		statsDialog_->show();
+	}
+
+	// update the plots with a new frame; all items are
+	// modified before each plot is replotted (once).
+	void
+	display(BufPtr buf)
+	{
+		if ( ! buf ) {
+			return;
+		}
+		StageTimer tim( reader_->getTiming(), Stage::GUI );
+		PlotUpdate mainUpd( plot_    );
+		PlotUpdate fftUpd ( secPlot_ );
+		newData( buf );
+	}
+
+	// take the newest frame (if any); frames arriving faster
+	// than the display rate are coalesced in the mailbox.
+	void
+	displayTick()
+	{
+		if ( reader_ ) {
+			display( reader_->getMbox() );
+		}
+	}
+
 
 	void
 	clrTrgLED()
@@ -509,7 +604,35 @@ public:
 	postSync()
 	{
 		cmd_.incrementSync();
-		pipe_->sendCmd( &cmd_ );
+		postCmd();
+	}
+
+	// settings which do not invalidate data already in flight
+	// (no sync increment)
+	void
+	postCmd()
+	{
+		cmdChnl_->sendCmd( &cmd_ );
+	}
+
+	// let the reader skip disabled channels; we must be the last
+	// subscriber (others may refuse the change).
+	virtual bool
+	channelEnableChanged(ChannelCtrl *ctrl) override
+	{
+		cmd_.setChannelEnabled( ctrl->getChannel(), ! ctrl->enabled() );
+		postCmd();
+		return true;
+	}
+
+	// let the reader skip the FFT while it is not visible
+	void
+	fftVisibilityChanged(bool visible)
+	{
+		if ( visible != cmd_.fftEnabled() ) {
+			cmd_.setFFTEnabled( visible );
+			postCmd();
+		}
 	}
 
 	void
@@ -537,6 +660,57 @@ public:
 		fftDockWid_->setFloating( false );
 	}
 
+	// the histograms span the full vertical range; hits fade
+	// to 1/e after 'persistFrames_' frames (0: never).
+	void
+	setPersistence(bool on)
+	{
+		if ( on ) {
+			double frames = persistFrames_ >= 0.0 ? persistFrames_ : PERSIST_FRAMES_DFLT;
+			persist_ = make_shared<PersistenceType>(
+			               getNumChannels(),
+			               std::min( PERSIST_XBINS, nsmpl_ ),
+			               PERSIST_YBINS,
+			               -vYScale_[CHA_IDX] - 1.0,
+			               vYScale_[CHA_IDX],
+			               frames > 0.0 ? exp( -1.0/frames ) : 1.0 );
+		} else {
+			persist_.reset();
+		}
+		for ( auto item : vPersistItems_ ) {
+			item->setPersistence( persist_ );
+		}
+		if ( reader_ ) {
+			reader_->setPersistence( persist_ );
+		}
+		plot_->replot();
+	}
+
+	void
+	clearPersistence()
+	{
+		if ( persist_ ) {
+			persist_->clear();
+			plot_->replot();
+		}
+	}
+
+	// the history is discarded when the waterfall is disabled
+	void
+	setWaterfall(bool on)
+	{
+		if ( on ) {
+			waterfall_ = make_shared<WaterfallType>( getNumChannels(), std::min( WATERFALL_COLS, nsmpl_/2 ), WATERFALL_ROWS );
+		} else {
+			waterfall_.reset();
+		}
+		waterfallWid_->setWaterfall( waterfall_ );
+		waterfallWid_->setVisible( on );
+		if ( reader_ ) {
+			reader_->setWaterfall( waterfall_ );
+		}
+	}
+
 	void
 	showHelp()
 	{
@@ -645,8 +819,16 @@ public:
 				H5Smpl    h5f( fileName, FLOAT_T, 0, 0, dims );
 				std::vector<Dim> onedim;
 				onedim.push_back( dims[0] );
+#ifdef CONFIG_FLOAT_SAMPLES
+				H5DSpace  h5s( onedim, FLOAT_T,  0, 0);
+#else
 				H5DSpace  h5s( onedim, DOUBLE_T, 0, 0);
+#endif
 				for ( auto ch = 0; ch < buf->getNumChannels(); ++ch ) {
+					if ( ! buf->dataValid( ch ) ) {
+						// skipped (disabled) channel; leave fill-value
+						continue;
+					}
 					dims[1].cnt(1).off(ch);
 					h5f.addHSlab( &dims, &h5s, buf->getData(ch) );
 				}
@@ -844,6 +1026,32 @@ public:
 	}
 };
 
+// selects the channel shown by the waterfall
+class WaterfallChannelMenu : public MenuButton {
+private:
+	WaterfallWidget *wid_;
+
+public:
+	WaterfallChannelMenu(const vector<QString> &names, WaterfallWidget *wid, QWidget *parent = nullptr)
+	: MenuButton( names, parent ),
+	  wid_      ( wid           )
+	{
+	}
+
+	// nobody subscribes
+	virtual void
+	accept(ValChangedVisitor *v) override
+	{
+	}
+
+	virtual void
+	notify(TxtAction *act) override
+	{
+		MenuButton::notify( act );
+		wid_->setChannel( act->index() );
+	}
+};
+
 class TrigLevel : public ParamValidator, public MovableMarker, public ParamValUpdater, public ValChangedVisitor {
 private:
 	Scope         *scp_;
@@ -1727,18 +1935,30 @@ public:
 Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 : QObject        ( parent                       ),
   Board          ( fw, cfg.sim                  ),
-  plotScales_    ( NUM_CHNLS                    ),
-  fftScales_     ( NUM_CHNLS                    ),
+  plotScales_    ( 0                            ),
+  fftScales_     ( 0                            ),
   reader_        ( nullptr                      ),
-  xRange_        ( nullptr                      ),
-  fRange_        ( nullptr                      ),
   nsmpl_         ( NSMPL_DFLT                   ),
-  pipe_          ( ScopeReaderCmdPipe::create() ),
+  cmdChnl_       ( ScopeReaderCmdChannel::create() ),
   trgArm_        ( nullptr                      ),
   single_        ( false                        ),
   lsync_         ( 0                            ),
   paramUpd_      ( nullptr                      ),
-  paramsPool_    ( this                         )
+  paramsPool_    ( this                         ),
+  displayHz_     ( cfg.displayHz < 0.0 ? DISPLAY_HZ_DFLT : cfg.displayHz ),
+  dspWorkers_    ( cfg.dspWorkers               ),
+  exactLog_      ( cfg.exactLog                 ),
+  lazyDSP_       ( cfg.lazyDSP                  ),
+  asyncDepth_    ( cfg.asyncDepth               ),
+  loopbackHz_    ( cfg.loopbackHz               ),
+  simSignals_    ( cfg.simSignals               ),
+  persistFrames_ ( cfg.persistFrames            ),
+  arenaFlags_    ( cfg.arenaFlags               ),
+  poolDepth_     ( cfg.poolDepth ? cfg.poolDepth : POOL_DEPTH_DFLT ),
+  poolPolicy_    ( cfg.poolPolicy               ),
+  poolTimeout_   ( cfg.poolTimeout              ),
+  poolBudget_    ( cfg.poolBudget               ),
+  rtCfg_         ( cfg.rt                       )
 {
 
 	paramsPool_.add( 20 );
@@ -1792,32 +2012,27 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 		cmd_.setScopeParams( p );
 	}
 
-	// Create horizontal indices for main plot
-	auto xRange = unique_ptr<double[]>( new double[ nsmpl_ ] );
-	xRange_ = xRange.get();
-	for ( int i = 0; i < nsmpl_; i++ ) {
-		xRange_[i] = (double)i;
-	}
-
-	// Create horizontal indices for fft plot
-	auto fRange = unique_ptr<double[]>( new double[ nsmpl_/2 ] );
-	fRange_ = fRange.get();
-	for ( int i = 0; i < nsmpl_/2; i++ ) {
-		fRange_[i] = (double)i;
-	}
-
 
 	auto paramUpd    = unique_ptr<ParamUpdateVisitor>( new ParamUpdateVisitor( this ) );
 	paramUpd_        = paramUpd.get();
 
-	// per-channel initialization of basic resources
-	vChannelColors_.push_back( QColor( Qt::blue  ) );
-	vChannelColors_.push_back( QColor( Qt::black ) );
+	// per-channel initialization of basic resources; the number
+	// of channels is a property of the board variant.
+	unsigned nch = cmd_.scopeParams()->numChannels;
+	if ( 0 == nch || nch > BufType::MAX_CHANNELS ) {
+		throw std::runtime_error( string("Scope::Scope - unsupported number of channels: ") + std::to_string( nch ) );
+	}
+
+	const QColor chnlColors[BufType::MAX_CHANNELS] = { QColor( Qt::blue ), QColor( Qt::black ), QColor( Qt::darkRed ), QColor( Qt::darkGreen ) };
 
 	// numChannels() is computed from vChannelNames, so that has to
 	// be initialized first.
-	vChannelNames_.push_back( "A" );
-	vChannelNames_.push_back( "B" );
+	for ( unsigned ch = 0; ch < nch; ++ch ) {
+		vChannelColors_.push_back( chnlColors[ch] );
+		vChannelNames_.push_back( QString( QChar( 'A' + ch ) ) );
+	}
+	plotScales_.v.resize( nch, nullptr );
+	fftScales_.v.resize ( nch, nullptr );
 
 	for ( auto it = vChannelNames_.begin();  it != vChannelNames_.end(); ++it ) {
 		vOvrLEDNames_.push_back( string("OVR") + it->toStdString() );
@@ -2088,6 +2303,11 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 		}
 	}
 
+	statsDialog_ = new StatsDialog( [this]() { return reader_; }, mainWid.get() );
+
+	displayTimer_ = new QTimer( this );
+	QObject::connect( displayTimer_, &QTimer::timeout, this, &Scope::displayTick );
+
 	formLay  = unique_ptr<QFormLayout>( new QFormLayout() );
 
 	// main central widget
@@ -2158,9 +2378,11 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 		// action cannot be styled; i.e., we cannot set the channel color
 		vChannelCtrl_[ch]->setAction( act.get() );
 		viewMen->addAction( act.release() );
+		vChannelCtrl_[ch]->subscribe( this );
 	}
 
 	viewMen->addAction( fftDockWid_->toggleViewAction() );
+	QObject::connect( fftDockWid_, &QDockWidget::visibilityChanged, this, &Scope::fftVisibilityChanged );
 
 	// this is necessary due to what I believe are bugs in Qt and/or the window system:
 	//   1) when the FFT is undocked by dragging then it is not taken over by the
@@ -2173,6 +2395,26 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 	QObject::connect( act.get(), &QAction::triggered, this, &Scope::redockFFT );
 	viewMen->addAction( act.release() );
 
+	act           = unique_ptr<QAction>( new QAction( "Persistence" ) );
+	act->setCheckable( true );
+	act->setChecked( persistFrames_ >= 0.0 );
+	QObject::connect( act.get(), &QAction::toggled, this, &Scope::setPersistence );
+	viewMen->addAction( act.release() );
+
+	act           = unique_ptr<QAction>( new QAction( "Clear Persistence" ) );
+	QObject::connect( act.get(), &QAction::triggered, this, &Scope::clearPersistence );
+	viewMen->addAction( act.release() );
+
+	act           = unique_ptr<QAction>( new QAction( "FFT Waterfall" ) );
+	act->setCheckable( true );
+	act->setChecked( false );
+	QObject::connect( act.get(), &QAction::toggled, this, &Scope::setWaterfall );
+	viewMen->addAction( act.release() );
+
+	if ( persistFrames_ >= 0.0 ) {
+		setPersistence( true );
+	}
+
 	// Help menu
 	auto toolMen  = menuBar->addMenu( "Tools" );
 	if ( clockGenDialog_ ) {
@@ -2187,6 +2429,10 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 	}
 
 
+	act           = unique_ptr<QAction>( new QAction( "Pipeline Statistics" ) );
+	QObject::connect( act.get(), &QAction::triggered, this, &Scope::showStats );
+	toolMen->addAction( act.release() );
+
 	act           = unique_ptr<QAction>( new QAction( "Program Firmware to Flash" ) );
 	QObject::connect( act.get(), &QAction::triggered, this, &Scope::programFlash );
 	toolMen->addAction( act.release() );
@@ -2214,8 +2460,6 @@ Scope::Scope(FWPtr fw, const ScopeCfg &cfg, QObject *parent)
 //	plot_->setAxisScaleEngine( QwtPlot::xBottom, new ScopeSclEng( axisHScl()     ) );
 
 	paramUpd.release();
-	xRange.release();
-	fRange.release();
 }
 
 unique_ptr<ScopePlot>
@@ -2232,14 +2476,33 @@ Scope::mkMainPlot()
 	sclDrw->setColor( &vChannelColors_[CHA_IDX] );
 	plot_->setAxisScale( QwtPlot::yLeft, -axisVScl(CHA_IDX)->rawScale() - 1, axisVScl(CHA_IDX)->rawScale() );
 
-	sclDrw        = new ScaleXfrm( true, "V", this, plot_ );
-	sclDrw->setRawScale( vYScale_[CHB_IDX] );
-	plotScales_.v[CHB_IDX] = sclDrw;
-	updateVScale( CHB_IDX );
-	plot_->setAxisScaleDraw( QwtPlot::yRight, sclDrw );
-	sclDrw->setColor( &vChannelColors_[CHB_IDX] );
-	plot_->setAxisScale( QwtPlot::yRight, -axisVScl(CHB_IDX)->rawScale() - 1, axisVScl(CHB_IDX)->rawScale() );
-	plot_->enableAxis( QwtPlot::yRight );
+	if ( getNumChannels() > CHB_IDX ) {
+		sclDrw        = new ScaleXfrm( true, "V", this, plot_ );
+		sclDrw->setRawScale( vYScale_[CHB_IDX] );
+		plotScales_.v[CHB_IDX] = sclDrw;
+		updateVScale( CHB_IDX );
+		plot_->setAxisScaleDraw( QwtPlot::yRight, sclDrw );
+		sclDrw->setColor( &vChannelColors_[CHB_IDX] );
+		plot_->setAxisScale( QwtPlot::yRight, -axisVScl(CHB_IDX)->rawScale() - 1, axisVScl(CHB_IDX)->rawScale() );
+		plot_->enableAxis( QwtPlot::yRight );
+	}
+
+	// there are only two vertical axes; additional channels
+	// have a scale which is not displayed
+	for ( unsigned ch = CHB_IDX + 1; ch < getNumChannels(); ++ch ) {
+		sclDrw        = new ScaleXfrm( true, "V", this, plot_ );
+		sclDrw->setRawScale( vYScale_[ch] );
+		plotScales_.v[ch] = sclDrw;
+		updateVScale( ch );
+		sclDrw->setColor( &vChannelColors_[ch] );
+	}
+
+	// persistence layers; draw nothing until enabled
+	for ( unsigned ch = 0; ch < getNumChannels(); ++ch ) {
+		auto item = new PersistenceItem( ch, vChannelColors_[ch] );
+		item->attach( plot_ );
+		vPersistItems_.push_back( item );
+	}
 
 	sclDrw        = new ScaleXfrm( false, "s", this, plot_ );
 	sclDrw->setRawScale( nsmpl_ - 1 );
@@ -2277,7 +2540,14 @@ Scope::mkFFTPlot()
 	secPlot_ = new FFTPlot( &vChannelColors_ );
 
 	auto horzLay  = unique_ptr<QHBoxLayout>( new QHBoxLayout() );
-	horzLay->addWidget( secPlot_, 8 );
+	auto vertLay  = unique_ptr<QVBoxLayout>( new QVBoxLayout() );
+	vertLay->addWidget( secPlot_, 3 );
+
+	// hidden until enabled from the 'View' menu
+	waterfallWid_ = new WaterfallWidget();
+	waterfallWid_->setVisible( false );
+	vertLay->addWidget( waterfallWid_, 2 );
+	horzLay->addLayout( vertLay.release(), 8 );
 
 	secPlot_->setAxisTitle( QwtPlot::yLeft, "dBfs" );
 	// one-sided spectrum; multiply half of two-sided spectrum
@@ -2289,9 +2559,10 @@ Scope::mkFFTPlot()
 	xfrm->setScale( 20.0 );
 	xfrm->setOffset( dbOff );
 	xfrm->setUseNormalizedScale( false );
-	// both channels use the same scale!
-	fftScales_.v[CHA_IDX] = xfrm;
-	fftScales_.v[CHB_IDX] = xfrm;
+	// all channels use the same scale!
+	for ( auto it = fftScales_.v.begin(); it != fftScales_.v.end(); ++it ) {
+		*it = xfrm;
+	}
 
 	secPlot_->setAxisScaleDraw( QwtPlot::yLeft, fftVScl(0) );
 	secPlot_->setAxisScaleEngine( QwtPlot::yLeft, new ScopeSclEng( fftVScl(0) ) );
@@ -2321,6 +2592,8 @@ Scope::mkFFTPlot()
 
 	formLay->addRow( grid.release() );
 
+	formLay->addRow( new QLabel( "Waterfall Channel:" ), new WaterfallChannelMenu( vChannelNames_, waterfallWid_ ) );
+
 	secPlot_->instantiateMovableMarkers();
 
 	for ( size_t ch = 0; ch < secPlot_->numCurves(); ++ch ) {
@@ -2336,12 +2609,6 @@ Scope::mkFFTPlot()
 
 Scope::~Scope()
 {
-	if ( xRange_ ) {
-		delete [] xRange_;
-	}
-	if ( fRange_ ) {
-		delete [] fRange_;
-	}
 	if ( paramUpd_ ) {
 		delete paramUpd_;
 	}
@@ -2351,7 +2618,10 @@ bool
 Scope::event(QEvent *event)
 {
 	if ( event->type() == DataReadyEvent::TYPE() ) {
-		newData( reader_->getMbox() );
+		// if the display rate is limited the timer picks up the frame
+		if ( ! displayTimer_->isActive() ) {
+			display( reader_->getMbox() );
+		}
 		return true;
 	}
 	return QObject::event( event );
@@ -2464,29 +2734,41 @@ Scope::newData(BufPtr buf)
 
 	unsigned hdr = buf->getHdr();
 
-	double triggerOffset = getTriggerOffset( buf );
-	for ( int i = 0; i < nsmpl_; i++ ) {
-		xRange_[i] = (double)i - triggerOffset;
-	}
+	// sample indices relative to the (interpolated) trigger point
+	LinearAbscissa xRange( 1.0, - getTriggerOffset( buf ) );
+	// FFT bins
+	LinearAbscissa fRange( 1.0, 0.0 );
 
 	for ( int ch = 0; ch < plot_->numCurves(); ch++ ) {
-		// samples
-		plot_->getCurve(ch)->setRawSamples( xRange_, buf->getData( ch ), buf->getNElms() );
+		// samples; the reader skips disabled channels and the
+		// FFT while it is hidden.
+		size_t n = buf->dataValid( ch ) ? buf->getNElms() : 0;
+		if ( n && buf->lodValid( ch ) ) {
+			// only the envelope at canvas resolution is drawn
+			plot_->getCurve(ch)->setData( new LODSeriesData<SampleType>( xRange, buf->getLOD( ch ), plot_->canvas()->width() ) );
+		} else {
+			plot_->getCurve(ch)->setData( new RawSeriesData<LinearAbscissa, SampleType>( xRange, buf->getData( ch ), n ) );
+		}
+		// the reader does not accumulate disabled channels
+		vPersistItems_[ch]->setVisible( n > 0 );
 
 		if ( secPlot_ ) {
-			secPlot_->getCurve(ch)->setRawSamples( fRange_, buf->getFFTModulus(ch), buf->getNElms()/2 );
+			n = buf->fftValid( ch ) ? buf->getNElms()/2 : 0;
+			secPlot_->getCurve(ch)->setData( new RawSeriesData<LinearAbscissa, SampleType>( fRange, buf->getFFTModulus(ch), n ) );
 		}
 
 		// measurements
 
-		ScaleXfrm *xfrm = axisVScl(ch);
+		if ( buf->dataValid( ch ) ) {
+			ScaleXfrm *xfrm = axisVScl(ch);
 
-		double val = xfrm->linr( buf->getAvg( ch ), false );
-		auto nrm  = xfrm->normalize( val );
-		vMeanLbls_[ch]->setText( QString::asprintf("%7.2f", val*nrm.first) + *nrm.second );
-		val  = xfrm->linr( buf->getStd( ch ), false );
-		nrm  = xfrm->normalize( val );
-		vStdLbls_ [ch]->setText( QString::asprintf("%7.2f", val*nrm.first) + *nrm.second );
+			double val = xfrm->linr( buf->getAvg( ch ), false );
+			auto nrm  = xfrm->normalize( val );
+			vMeanLbls_[ch]->setText( QString::asprintf("%7.2f", val*nrm.first) + *nrm.second );
+			val  = xfrm->linr( buf->getStd( ch ), false );
+			nrm  = xfrm->normalize( val );
+			vStdLbls_ [ch]->setText( QString::asprintf("%7.2f", val*nrm.first) + *nrm.second );
+		}
 
 		// overrange flag
 		bool ovrRng = acq_.bufHdrFlagOverrange( hdr, ch );
@@ -2497,8 +2779,18 @@ Scope::newData(BufPtr buf)
 		}
 	}
 
+	if ( waterfall_ ) {
+		// colors follow the vertical range of the FFT plot
+		const QwtScaleDiv &div = secPlot_->axisScaleDiv( QwtPlot::yLeft );
+		waterfallWid_->setRange( div.lowerBound(), div.upperBound() );
+		waterfallWid_->refresh();
+	}
+
+	{
+	StageTimer tim( reader_->getTiming(), Stage::MEASURE );
 	plot_->notifyMarkersValChanged();
 	secPlot_->notifyMarkersValChanged();
+	}
 
 	leds_->setVal( "Trig", 1 );
 	lsync_ = buf->getSync();
@@ -2525,8 +2817,15 @@ Scope::startReader(unsigned poolDepth)
 		throw std::runtime_error( string(__func__) + " reader already started" );
 	}
 	size_t rawElSz = acq()->getBufSampleSize();
-	BufPoolPtr bufPool = make_shared<BufPoolPtr::element_type>( nsmpl_, rawElSz );
-	bufPool->add( poolDepth );
+	BufPoolPtr bufPool = make_shared<BufPoolPtr::element_type>( getNumChannels(), nsmpl_, rawElSz );
+	bufPool->setArenaFlags( arenaFlags_ );
+	bufPool->setPolicy( poolPolicy_, poolTimeout_, (size_t)poolBudget_ * 1024 * 1024 );
+	if ( 0 == poolDepth ) {
+		poolDepth = poolDepth_;
+	}
+	// asynchronous acquisition holds its completions plus
+	// the buffer being filled
+	bufPool->add( poolDepth + ( asyncDepth_ ? asyncDepth_ + 1 : 0 ) );
 
 	std::unique_ptr<QProgressDialog> progress( new QProgressDialog( mainWin_.get() ) );
 	progress->setLabel( new QLabel( "Computing FFT Wisdom; please be patient" ) );
@@ -2537,19 +2836,34 @@ Scope::startReader(unsigned poolDepth)
 	progress->setWindowModality( Qt::WindowModal );
 	QObject::connect( progress.get(), &QProgressDialog::canceled, this, &Scope::quitAndExit );
 	progress->setValue(0);
-	reader_ = new ScopeReader( unlockedPtr(), bufPool, pipe_, this );
+	reader_ = new ScopeReader( unlockedPtr(), bufPool, cmdChnl_, this, dspWorkers_ );
+	reader_->setFastLog( ! exactLog_ );
+	reader_->setLazyDSP( lazyDSP_ );
+	reader_->setAsyncDepth( asyncDepth_ );
+	reader_->setRTCfg( rtCfg_ );
+	reader_->setPersistence( persist_ );
+	reader_->setWaterfall( waterfall_ );
+	if ( ! simSignals_.empty() ) {
+		reader_->useSimSource( loopbackHz_ > 0.0 ? loopbackHz_ : SIM_RATE_DFLT, simSignals_, getADCClkFreq() );
+	} else if ( loopbackHz_ > 0.0 ) {
+		reader_->useLoopback( loopbackHz_ );
+	}
 	Planner p(reader_, progress.get());
 	p.start();
 	progress->exec();
 	p.wait();
 	reader_->start();
+	if ( displayHz_ > 0.0 ) {
+		displayTimer_->start( std::max( 1, (int)lround( 1000.0/displayHz_ ) ) );
+	}
 }
 
 void
 Scope::stopReader()
 {
+	displayTimer_->stop();
 	cmd_.stop_ = true;
-	pipe_->sendCmd( &cmd_ );
+	cmdChnl_->sendCmd( &cmd_ );
 	reader_->wait();
 	// process events: make sure all data that may have been
 	// posted by the reader is processed before we take
@@ -2712,7 +3026,7 @@ Scope::updateScale( ScaleXfrm *xfrm )
 double
 Scope::getRawSample(int channel, int idx)
 {
-	if ( channel < 0 || channel >= getNumChannels() || ! curBuf_  ) {
+	if ( channel < 0 || channel >= getNumChannels() || ! curBuf_ || ! curBuf_->dataValid( channel ) ) {
 		return NAN;
 	}
 	if ( idx < 0 ) {
@@ -2726,7 +3040,7 @@ Scope::getRawSample(int channel, int idx)
 double
 Scope::getRawFFTSample(int channel, int idx)
 {
-	if ( channel < 0 || channel >= getNumChannels() || ! curBuf_  ) {
+	if ( channel < 0 || channel >= getNumChannels() || ! curBuf_ || ! curBuf_->fftValid( channel ) ) {
 		return NAN;
 	}
 	size_t fftSize = curBuf_->getNElms()/2;
@@ -2905,7 +3219,7 @@ static void
 usage(const char *nm)
 {
 	const char *msg = (0 == scope_json_supported()) ? " [-j <json_file]" : "";
-	printf("usage: %s [-hsr] [-d <tty_device>] [-n <num_samples>]%s [-p <hdf5_path>] [-S <full_scale_volt>]\n", nm, msg);
+	printf("usage: %s [-hsrxzHLm] [-b <pool_depth>] [-B <pool_policy>] [-d <tty_device>] [-n <num_samples>]%s [-p <hdf5_path>] [-S <full_scale_volt>] [-w <dsp_threads>] [-a <async_depth>] [-l <loopback_rate>] [-R <sched_spec>] [-D <sched_spec>] [-C <rt_json>] [-g <signal>] [-P <persist_frames>] [-F <display_rate>]\n", nm, msg);
 	printf("  -h                  : Print this message.\n");
     printf("  -d tty_device       : Path to TTY device (defaults to '/dev/ttyACM0').\n");
 	printf("  -S full_scale_volt  : Change scale to 'full_scale_volt' (at 0dB\n");
@@ -2926,6 +3240,92 @@ usage(const char *nm)
 	printf("                        upon quitting the application. By default a safe\n");
 	printf("                        state (maximize all attenuators, remove termination\n");
 	printf("                        etc.) is programmed.\n");
+	printf("  -w dsp_threads      : Number of threads processing channels in parallel\n");
+	printf("                        (defaults to zero which uses one per channel if\n");
+	printf("                        the machine has enough CPUs).\n");
+	printf("  -x                  : Use the exact (libm) logarithm when computing\n");
+	printf("                        the FFT magnitude (default is a vectorized\n");
+	printf("                        approximation with <1E-6dB error).\n");
+	printf("  -z                  : Lazy processing: only process a new frame once\n");
+	printf("                        the GUI has picked up the previous one; frames\n");
+	printf("                        triggering faster than the display rate are\n");
+	printf("                        dropped without being processed.\n");
+	printf("  -F display_rate     : Maximal display refresh rate in Hz (defaults to\n");
+	printf("                        %g). Frames are acquired and processed at the full\n", Scope::DISPLAY_HZ_DFLT);
+	printf("                        rate; only the newest is displayed. 0 displays\n");
+	printf("                        every frame the GUI can keep up with.\n");
+	printf("  -P persist_frames   : Enable the persistence display (can also be\n");
+	printf("                        toggled from the 'View' menu); hits fade to 1/e\n");
+	printf("                        after 'persist_frames' processed frames (0:\n");
+	printf("                        infinite persistence; defaults to %g).\n", Scope::PERSIST_FRAMES_DFLT);
+	printf("  -a async_depth      : Read from the device in a separate thread which\n");
+	printf("                        has the next buffer ready and holds up to\n");
+	printf("                        'async_depth' completed frames (defaults to zero:\n");
+	printf("                        synchronous reads).\n");
+	printf("  -l loopback_rate    : Acquire synthetic frames at 'loopback_rate' Hz\n");
+	printf("                        instead of reading the device (for testing and\n");
+	printf("                        benchmarking).\n");
+	printf("  -g signal           : Acquire simulated signals instead of reading the\n");
+	printf("                        device; repeat for channels A, B, ... (others\n");
+	printf("                        produce noise). 'signal' is\n");
+	printf("                          <sine|square|noise|burst>[:Hz[:Volt[:offset]]]\n");
+	printf("                        (amplitude and offset in Volts at the input, RMS\n");
+	printf("                        for noise). The generator honors decimation,\n");
+	printf("                        trigger settings and channel ranges. Frames are\n");
+	printf("                        produced at 'loopback_rate' (-l; defaults to %g).\n", Scope::SIM_RATE_DFLT);
+	printf("                        Only the sample data are simulated; settings are\n");
+	printf("                        still programmed into the device (or into the\n");
+	printf("                        simulated HDL app with -s).\n");
+	printf("  -H                  : Back sample buffers by huge pages (if available).\n");
+	printf("  -L                  : Lock sample buffers in memory.\n");
+	printf("  -b pool_depth       : Number of sample buffers (defaults to %u).\n", Scope::POOL_DEPTH_DFLT);
+	printf("  -B pool_policy      : What to do if all sample buffers are in use:\n");
+	printf("                          fail      : skip frames (default),\n");
+	printf("                          block[:ms]: wait up to 'ms' milli-seconds\n");
+	printf("                                      for a buffer (defaults to 500),\n");
+	printf("                          grow[:MB] : add buffers up to a total of 'MB'\n");
+	printf("                                      mega-bytes (defaults to 1024),\n");
+	printf("                          drop      : discard the oldest unprocessed frame.\n");
+	printf("  -R sched_spec       : Scheduling of the reader (and transfer) thread;\n");
+	printf("                        'sched_spec' is <policy>[:<prio>][@<cpus>] with\n");
+	printf("                        policy 'fifo', 'rr' or 'other' and a list of CPUs\n");
+	printf("                        to pin to, e.g., 'fifo:80@2' or '@2-3'. Real-time\n");
+	printf("                        policies need CAP_SYS_NICE or RLIMIT_RTPRIO; a\n");
+	printf("                        warning is printed if the setting fails.\n");
+	printf("  -D sched_spec       : Scheduling of the DSP threads (see -R).\n");
+	printf("  -m                  : Lock all process memory (mlockall).\n");
+	printf("  -C rt_json          : Load -R/-D/-m settings from a JSON file, e.g.,\n");
+	printf("                        {\"reader\":{\"policy\":\"fifo\",\"priority\":80,\n");
+	printf("                         \"cpus\":[2]},\"dsp\":{\"policy\":\"rr\",\n");
+	printf("                         \"priority\":70,\"cpus\":[3,4]},\"lockMemory\":true}\n");
+	printf("                        Options are processed in order, i.e., later ones\n");
+	printf("                        override earlier ones.\n");
+}
+
+static bool
+parsePoolPolicy(const char *arg, ScopeCfg *cfg)
+{
+	const char *col = strchr( arg, ':' );
+	size_t      len = col ? (size_t)(col - arg) : strlen( arg );
+	unsigned   *u_p = nullptr;
+
+	if        ( 0 == strncmp( arg, "fail",  len ) && 4 == len ) {
+		cfg->poolPolicy = ADCBufPoolPolicy::FAIL;
+	} else if ( 0 == strncmp( arg, "block", len ) && 5 == len ) {
+		cfg->poolPolicy = ADCBufPoolPolicy::BLOCK;
+		u_p             = &cfg->poolTimeout;
+	} else if ( 0 == strncmp( arg, "grow",  len ) && 4 == len ) {
+		cfg->poolPolicy = ADCBufPoolPolicy::GROW;
+		u_p             = &cfg->poolBudget;
+	} else if ( 0 == strncmp( arg, "drop",  len ) && 4 == len ) {
+		cfg->poolPolicy = ADCBufPoolPolicy::DROP_OLDEST;
+	} else {
+		return false;
+	}
+	if ( col ) {
+		return u_p && 1 == sscanf( col + 1, "%u", u_p );
+	}
+	return true;
 }
 
 int
@@ -2952,21 +3352,72 @@ double      scale    = -1.0;
 	//
 	QApplication app(argc, argv);
 
-	while ( (opt = getopt( argc, argv, "d:hn:p:rsS:j:V" )) > 0 ) {
+	while ( (opt = getopt( argc, argv, "a:b:B:C:d:D:F:g:hHl:Lmn:p:P:rR:sS:j:Vw:xz" )) > 0 ) {
 		u_p = nullptr;
 		d_p = nullptr;
 		s_p = nullptr;
 		switch ( opt ) {
+			case 'a': u_p  = &scopeCfg.asyncDepth; break;
+			case 'b': u_p  = &scopeCfg.poolDepth;  break;
+			case 'B':
+				if ( ! parsePoolPolicy( optarg, &scopeCfg ) ) {
+					fprintf(stderr, "Error: invalid pool policy '%s'\n", optarg);
+					usage( argv[0] );
+					return 1;
+				}
+				break;
+			case 'C':
+				try {
+					scopeCfg.rt.load( optarg );
+				} catch ( std::exception &e ) {
+					fprintf(stderr, "Error: %s\n", e.what());
+					return 1;
+				}
+				break;
 			case 'd': fnam = optarg;           break;
+			case 'D':
+				if ( ! scopeCfg.rt.dsp.parse( optarg ) ) {
+					fprintf(stderr, "Error: invalid scheduling spec '%s'\n", optarg);
+					usage( argv[0] );
+					return 1;
+				}
+				break;
+			case 'F': d_p  = &scopeCfg.displayHz;  break;
+			case 'g':
+				{
+				SimSignal sig;
+				if ( ! sig.parse( optarg ) ) {
+					fprintf(stderr, "Error: invalid signal spec '%s'\n", optarg);
+					usage( argv[0] );
+					return 1;
+				}
+				scopeCfg.simSignals.push_back( sig );
+				}
+				break;
 			case 'h': usage( argv[0] );        return 0;
+			case 'H': scopeCfg.arenaFlags |= BufArena::HUGE_PAGES; break;
 			case 'j': scopeCfg.jsonFnam = optarg;  break;
+			case 'l': d_p  = &scopeCfg.loopbackHz; break;
+			case 'L': scopeCfg.arenaFlags |= BufArena::LOCKED;     break;
+			case 'm': scopeCfg.rt.lockMemory = true; break;
 			case 'n': s_p  = optarg;           break;
 			case 'p': path     = optarg;       break;
+			case 'P': d_p  = &scopeCfg.persistFrames; break;
 			case 'r': safeQuit = false;        break;
+			case 'R':
+				if ( ! scopeCfg.rt.reader.parse( optarg ) ) {
+					fprintf(stderr, "Error: invalid scheduling spec '%s'\n", optarg);
+					usage( argv[0] );
+					return 1;
+				}
+				break;
 			case 's': scopeCfg.sim = true;     break;
 			case 'S': d_p  = &scale;           break;
 			// need multiple V to enable debugging widgets
 			case 'V': scopeCfg.versaClkDbg++;  break;
+			case 'w': u_p  = &scopeCfg.dspWorkers; break;
+			case 'x': scopeCfg.exactLog = true;    break;
+			case 'z': scopeCfg.lazyDSP  = true;    break;
 			default:
 				fprintf(stderr, "Error: Unknown option -%c\n", opt);
 				usage( argv[0] );
@@ -3017,6 +3468,10 @@ double      scale    = -1.0;
 		scopeCfg.jsonFnam = nullptr;
 	}
 
+	if ( scopeCfg.rt.lockMemory ) {
+		lockProcessMemory();
+	}
+
 	Scope sc( FWComm::create( fnam ), scopeCfg );
 	if ( scale > 0.0 ) {
 		int i;
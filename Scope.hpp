@@ -27,61 +27,100 @@
 #pragma once
 
 #include <memory>
+#include <atomic>
 
 #include <QString>
 #include <QMessageBox>
 
 #include <FWComm.hpp>
 #include <ADCBuf.hpp>
+#include <BufTypes.hpp>
 #include <SysPipe.hpp>
+#include <EventFD.hpp>
+#include <BufPool.hpp>
 #include <AcqCtrl.hpp>
 #include <ScopeParams.hpp>
 
-static  constexpr size_t FIX_HARDCODED_NCH = 2;
-
 struct ScopeReaderCmd : AcqSettings {
 	bool            stop_{ false };
 };
 
-typedef ADCBufPool<double,FIX_HARDCODED_NCH>  BufPoolType;
-typedef std::shared_ptr< BufPoolType >        BufPoolPtr;
-typedef BufPoolType::ADCBufType               BufType;
-typedef BufPoolType::ADCBufPtr                BufPtr;
 typedef std::shared_ptr< SysPipe >            PipePtr;
 
-class ScopeReaderCmdPipe;
+class ScopeReaderCmdChannel;
+
+typedef std::shared_ptr<ScopeReaderCmdChannel> ScopeReaderCmdChannelPtr;
 
-typedef std::shared_ptr<ScopeReaderCmdPipe> ScopeReaderCmdPipePtr;
+// GUI -> ScopeReader commands. Every command is a complete snapshot
+// of the settings, hence the reader only needs the most recent one:
+// commands are passed (by value) through a lock-free mailbox which
+// coalesces commands the reader has not picked up yet. The eventfd
+// lets the reader poll() for commands alongside the IRQ descriptor.
+class ScopeReaderCmdChannel {
+private:
+	BufMailbox<ScopeReaderCmd> mbox_;
+	EventFD                    evfd_;
+	std::atomic<unsigned>      lastSync_ {0};
 
-class ScopeReaderCmdPipe : public SysPipe {
 public:
-	ScopeReaderCmdPipe()
+	ScopeReaderCmdChannel()
 	{
 	}
 
 	void
 	sendCmd(const ScopeReaderCmd *cmd)
 	{
-		// make sure the object is safe to serialize
-		// (increment refcount of any embedded shared
-		// pointers)
-		cmd->prepareForSerialization();
-		write( cmd, sizeof(*cmd) );
+		// publish before posting so the reader never sees
+		// a command that is newer than lastSync_
+		lastSync_.store( cmd->getSync() );
+		ScopeReaderCmd el( *cmd );
+		if ( mbox_.post( el ) ) {
+			evfd_.signal();
+		}
+		// 'el' now holds a stale command (if any) and is
+		// released here, in the GUI thread.
+	}
+
+	// sync value of the most recently sent command; the
+	// reader may not have received it yet. Data with a
+	// different sync value are discarded by the GUI.
+	unsigned
+	getLastSync() const
+	{
+		return lastSync_.load();
+	}
+
+	// allow for poll
+	int
+	getReadFD()
+	{
+		return evfd_.getFD();
+	}
+
+	// fetch the newest command; returns false if there is none
+	// (e.g., because it was already picked up).
+	bool
+	tryGetCmd(ScopeReaderCmd *cmd)
+	{
+		// clear first; a command posted after this
+		// point will signal again.
+		evfd_.clear();
+		return mbox_.take( *cmd );
 	}
 
+	// block until a command is available
 	void
 	waitCmd(ScopeReaderCmd *cmd)
 	{
-		// release embedded SHPs since it will be
-		// 'hard-overwritten'
-		cmd->resetShp();
-		read( cmd, sizeof(*cmd) );
+		while ( ! tryGetCmd( cmd ) ) {
+			evfd_.wait();
+		}
 	}
 
-	static ScopeReaderCmdPipePtr
+	static ScopeReaderCmdChannelPtr
 	create()
 	{
-		return std::make_shared<ScopeReaderCmdPipe>();
+		return std::make_shared<ScopeReaderCmdChannel>();
 	}
 };
 
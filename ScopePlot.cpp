@@ -80,6 +80,8 @@ ScopePlot::ScopePlot( std::vector<QColor> *vChannelColors, QWidget *parent )
     for (int i = 0; i < vChannelColors->size(); i++ ) {
         auto curv = unique_ptr<QwtPlotCurve>( new QwtPlotCurve() );
         curv->setPen( (*vChannelColors)[i] );
+        // series data with a level-of-detail need the visible rectangle
+        curv->setItemInterest( QwtPlotItem::ScaleInterest, true );
         curv->attach( this );
         vPltCurv_.push_back( curv.release() );
     }
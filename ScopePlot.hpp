@@ -101,6 +101,34 @@ public:
 	virtual ~ScopePlot();
 };
 
+// Suspends auto-replot of 'plot' (may be NULL) while a batch of
+// items is modified and replots once when done; otherwise every
+// modified item triggers a replot of its own.
+class PlotUpdate {
+	QwtPlot *plot_;
+	bool     autoReplot_;
+public:
+	PlotUpdate(QwtPlot *plot)
+	: plot_      ( plot                         ),
+	  autoReplot_( plot && plot->autoReplot()   )
+	{
+		if ( plot_ ) {
+			plot_->setAutoReplot( false );
+		}
+	}
+
+	PlotUpdate(const PlotUpdate &)            = delete;
+	PlotUpdate &operator=(const PlotUpdate &) = delete;
+
+	~PlotUpdate()
+	{
+		if ( plot_ ) {
+			plot_->setAutoReplot( autoReplot_ );
+			plot_->replot();
+		}
+	}
+};
+
 class FFTPlot : public ScopePlot {
 public:
 	FFTPlot( std::vector<QColor> *colors, QWidget *parent=nullptr )
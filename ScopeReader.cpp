@@ -29,29 +29,51 @@
 #include <time.h>
 #include <system_error>
 #include <string>
+#include <algorithm>
+#include <vector>
 
 using std::string;
 
+static unsigned
+dspWorkersDefault(unsigned nch)
+{
+	unsigned ncpu = std::thread::hardware_concurrency();
+	return ncpu ? std::min( ncpu, nch ) : 1;
+}
+
 ScopeReader::ScopeReader(
-		BoardInterface        *brd,
-		BufPoolPtr             bufPool,
-		ScopeReaderCmdPipePtr  pipe,
-		QObject               *notified,
-		QObject               *parent
+		BoardInterface           *brd,
+		BufPoolPtr                bufPool,
+		ScopeReaderCmdChannelPtr  cmdChnl,
+		QObject                  *notified,
+		unsigned                  dspWorkers,
+		QObject                  *parent
 )
 : QThread       ( parent   ),
   acq_          ( brd      ),
   bufPool_      ( bufPool  ),
-  pipe_         ( pipe     ),
+  cmdChnl_      ( cmdChnl  ),
+  xport_        ( new AcqCtrlTransport( &acq_ ) ),
   notified_     ( notified ),
-  bytesPerSmpl_ ( acq_.getBufSampleSize() * BufPoolType::NumChannels )
+  bytesPerSmpl_ ( acq_.getBufSampleSize() * bufPool->getNumChannels() ),
+  dspQueue_     ( DSP_QUEUE_DEPTH ),
+  workers_      ( dspWorkers ? dspWorkers : dspWorkersDefault( bufPool->getNumChannels() ) )
 {
 	if ( 2 == acq_.getBufSampleSize() ) {
-		readBuf_  = new ReadBuf<int16_t>( &acq_ );
+		readBuf_  = new ReadBuf<int16_t>();
 	} else {
-		readBuf_  = new ReadBuf<int8_t>( &acq_ );
+		readBuf_  = new ReadBuf<int8_t>();
 	}
-
+	// DROP_OLDEST pool policy: sacrifice the oldest frame waiting
+	// for the DSP stage
+	bufPool_->setReclaim( [this]() -> bool {
+		if ( dspQueue_.tryPopHead() ) {
+			framesDropped_++;
+			return true;
+		}
+		return false;
+	} );
+	printf("ScopeReader: %u DSP thread(s), '%s' kernels\n", workers_.size(), DSPKernels::getISA());
 }
 
 
@@ -64,24 +86,222 @@ void ScopeReader::createFFTWPlan(bool readWisdom, bool writeWisdom)
 	// this plan but use the 'new array' interface!
 
 	if ( readWisdom ) {
-		fftw_import_wisdom_from_filename("scope_fftw_wisdom.bin");
+		BufType::FFTW::importWisdom( BufType::FFTW::WISDOM_FILE );
 	}
 
-	fftwPlan_ = fftw_plan_dft_r2c_1d( buf->getMaxNElms(), buf->getData(0), buf->getFFT(0), FFTW_MEASURE | FFTW_PRESERVE_INPUT );
+	fftwPlan_ = BufType::FFTW::planR2C( buf->getMaxNElms(), buf->getData(0), buf->getFFT(0), FFTW_MEASURE | FFTW_PRESERVE_INPUT );
 
 	if ( writeWisdom ) {
-		fftw_export_wisdom_to_filename("scope_fftw_wisdom.bin");
+		BufType::FFTW::exportWisdom( BufType::FFTW::WISDOM_FILE );
 	}
 }
 
+void
+ScopeReader::useLoopback(double rateHz)
+{
+	xport_.reset( new LoopbackTransport( acq_.getBufSampleSize(), bufPool_->getNumChannels(), rateHz ) );
+	printf("ScopeReader: using loopback source (%g frames/s)\n", rateHz);
+}
+
+void
+ScopeReader::useSimSource(double rateHz, const std::vector<SimSignal> &sigs, double adcClkHz)
+{
+	xport_.reset( new SimTransport( acq_.getBufSampleSize(), bufPool_->getNumChannels(), rateHz, sigs, adcClkHz ) );
+	printf("ScopeReader: using simulated signals (%g frames/s)\n", rateHz);
+}
+
 ScopeReader::~ScopeReader()
 {
+		bufPool_->setReclaim( nullptr );
 		if ( fftwPlan_ ) {
-			fftw_destroy_plan( fftwPlan_ );
+			BufType::FFTW::destroyPlan( fftwPlan_ );
 		}
 		delete readBuf_;
 }
 
+ScopeReaderStats
+ScopeReader::getStats()
+{
+	ScopeReaderStats st;
+	st.framesRead        = framesRead_.load();
+	st.bytesRead         = bytesRead_.load();
+	st.framesProcessed   = framesProcessed_.load();
+	st.framesDropped     = framesDropped_.load();
+	st.framesStale       = framesStale_.load();
+	st.dspQueueFill      = dspQueue_.fill();
+	st.dspQueueHighWater = dspQueue_.highWaterMark();
+	st.dspQueueDepth     = dspQueue_.depth();
+	st.readBusy          = readBusy_.load();
+	st.dspBusy           = dspBusy_.load();
+	st.mboxFull          = mbox_.full();
+	st.mboxPosted        = mboxPosted_.load();
+	st.mboxCoalesced     = mboxCoalesced_.load();
+	st.mboxConsumed      = mboxConsumed_.load();
+	st.framesNoBuf       = framesNoBuf_.load();
+	st.pool              = bufPool_->getStats();
+	if ( async_ ) {
+		st.acqTransfers  = async_->getTransfers();
+		st.acqDropped    = async_->getDropped();
+		st.acqFlushed    = async_->getFlushed();
+		st.acqPoolEmpty  = async_->getPoolEmpty();
+		st.acqFill       = async_->getFill();
+	}
+	return st;
+}
+
+void
+ScopeReader::queueForDSP(BufPtr *buf)
+{
+	while ( ! dspQueue_.tryPushTail( *buf ) ) {
+		// DSP stage cannot keep up; discard the oldest frame
+		// so that the freshest data are processed next.
+		if ( dspQueue_.tryPopHead() ) {
+			framesDropped_++;
+		}
+	}
+}
+
+void
+ScopeReader::deliver(BufPtr *buf, ScopeReaderCmd *cmd, uint16_t hdr, unsigned nbytes)
+{
+	unsigned nelms = nbytes / bytesPerSmpl_;
+	// initHdr must be called first (sets nelms_)
+	(*buf)->initHdr( cmd, hdr, nelms );
+	framesRead_++;
+	bytesRead_ += nbytes;
+	// processing is done by the DSP stage while we
+	// read the next buffer
+	queueForDSP( buf );
+}
+
+bool
+ScopeReader::process(BufPtr &buf)
+{
+	unsigned nch = buf->getNumChannels();
+	if ( isStale( buf ) ) {
+		return false;
+	}
+	unsigned nelms  = buf->getNElms();
+	unsigned nparts = workers_.size();
+	// split de-interleaving into chunks which are a multiple of
+	// the vector length
+	unsigned chunk  = ( (nelms + nparts - 1)/nparts + 63 ) & ~63;
+	// raw statistics of each chunk
+	std::vector<DSPKernels::RawStats> stats( nparts*nch );
+
+	{
+	StageTimer tim( timing_, Stage::COPY );
+	workers_.run( nparts, [this, &buf, &stats, nelms, chunk, nch](unsigned part) {
+		unsigned first = part * chunk;
+		if ( first < nelms ) {
+			readBuf_->copy( buf, first, std::min( chunk, nelms - first ), &stats[part*nch] );
+		} else {
+			for ( unsigned ch = 0; ch < nch; ++ch ) {
+				stats[part*nch + ch].reset();
+			}
+		}
+	} );
+	}
+
+	// skipped channels remain marked invalid
+	unsigned chans[BufType::MAX_CHANNELS];
+	unsigned nchans = 0;
+	for ( unsigned ch = 0; ch < nch; ++ch ) {
+		if ( ! buf->channelProcessed( ch ) ) {
+			continue;
+		}
+		for ( unsigned part = 1; part < nparts; ++part ) {
+			stats[ch].merge( stats[part*nch + ch] );
+		}
+		buf->setRawStats( ch, stats[ch] );
+		chans[nchans++] = ch;
+	}
+
+	{
+	StageTimer tim( timing_, Stage::LOD );
+	workers_.run( nchans, [&buf, &chans](unsigned i) {
+		buf->computeLOD( chans[i] );
+	} );
+	}
+
+	if ( PersistencePtr pers = std::atomic_load( &persist_ ) ) {
+		StageTimer tim( timing_, Stage::PERSIST );
+		workers_.run( nchans, [&buf, &chans, &pers](unsigned i) {
+			pers->accumulate( chans[i], buf->getData( chans[i] ), buf->getNElms(), buf->getSync() );
+		} );
+	}
+
+	if ( isStale( buf ) ) {
+		return false;
+	}
+
+	if ( ! buf->fftEnabled() ) {
+		return true;
+	}
+
+	// channels are independent; fftw_execute_dft_r2c (new-array
+	// interface) may be used concurrently with the same plan.
+	bool fast = fastLog_.load( std::memory_order_relaxed );
+	WaterfallPtr wf = std::atomic_load( &waterfall_ );
+	workers_.run( nchans, [this, &buf, &chans, &wf, fast](unsigned i) {
+		if ( isStale( buf ) ) {
+			return;
+		}
+		unsigned ch = chans[i];
+		{
+		StageTimer tim( timing_, Stage::FFT );
+		BufType::FFTW::executeR2C( fftwPlan_, buf->getData( ch ), buf->getFFT( ch ) );
+		}
+		{
+		StageTimer tim( timing_, Stage::ABS_FFT );
+		buf->computeAbsFFT( ch, fast );
+		}
+		if ( wf ) {
+			// same bins as displayed by the FFT plot
+			wf->push( ch, buf->getFFTModulus( ch ), buf->getNElms()/2 );
+		}
+	} );
+
+	return ! isStale( buf );
+}
+
+void
+ScopeReader::waitMboxEmpty()
+{
+	std::unique_lock<std::mutex> lg( mutx_ );
+	mboxTaken_.wait( lg, [this]() {
+		return ! mbox_.full() || ! lazyDSP_.load() || dspStop_.load();
+	} );
+}
+
+void
+ScopeReader::dspLoop()
+{
+	BufPtr buf;
+	for (;;) {
+		// the read stage keeps replacing the queued frame
+		// while we wait so we get the freshest one.
+		waitMboxEmpty();
+		// an empty buffer terminates the loop
+		if ( ! (buf = dspQueue_.popHead()) ) {
+			break;
+		}
+		dspBusy_++;
+		bool ok = process( buf );
+		dspBusy_--;
+		if ( ! ok ) {
+			// the GUI would discard it anyways
+			framesStale_++;
+			buf.reset();
+			continue;
+		}
+		framesProcessed_++;
+		postMbox( &buf );
+		// release any buffer the GUI did not pick up
+		buf.reset();
+	}
+}
+
 void
 ScopeReader::run()
 {
@@ -94,12 +314,18 @@ ScopeReader::run()
 		abort();
 	}
 
-	pfd[nfds].fd     = pipe_->getReadFD();
+	if ( asyncDepth_ ) {
+		async_.reset( new AsyncAcq( xport_.get(), bufPool_, asyncDepth_ ) );
+	}
+
+	pfd[nfds].fd     = cmdChnl_->getReadFD();
 	pfd[nfds].events = POLLIN;
 	nfds ++;
 
-	pfd[nfds].fd = acq_.getIrqFD( 0 );
+	// in asynchronous mode we wait for completed transfers
+	pfd[nfds].fd = async_ ? async_->getFD() : xport_->getReadyFD();
 	if ( pfd[nfds].fd >= 0 ) {
+		pfd[nfds].events = POLLIN;
 		timo = -1; // indefinite
 		nfds ++;
 	}
@@ -107,56 +333,107 @@ ScopeReader::run()
 
 	BufPtr         buf;
 	ScopeReaderCmd cmd;
-	unsigned       got   = 0;
 	uint16_t       hdr;
 
 	// must wait until we have parameters
-	pipe_->waitCmd( &cmd );
+	cmdChnl_->waitCmd( &cmd );
+	xport_->setParams( cmd.scopeParams() );
+
+	applyThreadRT( pthread_self(), rtCfg_.reader, "reader" );
+
+	dspThread_ = std::thread( &ScopeReader::dspLoop, this );
+	applyThreadRT( dspThread_.native_handle(), rtCfg_.dsp, "DSP" );
+	for ( unsigned i = 0; i + 1 < workers_.size(); i++ ) {
+		applyThreadRT( workers_.nativeHandle( i ), rtCfg_.dsp, "DSP worker" );
+	}
+
+	if ( async_ ) {
+		async_->start();
+		applyThreadRT( async_->nativeHandle(), rtCfg_.reader, "transfer" );
+	}
 
 	while ( ! cmd.stop_ ) {
+		// bytes read into 'buf' during this iteration
+		unsigned got = 0;
 
-		if ( ! buf ) {
-			buf = bufPool_->get();
+		if ( ! buf && ! async_ ) {
+			try {
+				buf = bufPool_->get();
+			} catch ( std::bad_alloc & ) {
+				// all buffers are downstream (according to the pool
+				// policy); the frame stays on the device until we
+				// have a buffer.
+				framesNoBuf_++;
+			}
 		}
 
-		int st = poll( pfd, nfds, timo );
+		// without a buffer we only listen for commands
+		int n  = ( buf || async_ ) ? nfds : 1;
+		int st;
+		{
+		StageTimer tim( timing_, Stage::POLL );
+		st = poll( pfd, n, n < nfds ? NOBUF_RETRY_MS : timo );
+		}
 
 		if ( st < 0 ) {
 			throw std::system_error( errno, std::generic_category(), __func__ );
 		}
 
+		readBusy_++;
 		if ( 0 == st ) {
-			// timeout due to polling mode;
-			got = readBuf_->read( & hdr, buf );
+			// timeout due to polling mode (or retry without buffer)
+			if ( buf ) {
+				StageTimer tim( timing_, Stage::READ );
+				got = xport_->read( &hdr, buf->getRawData(), buf->getRawSize() );
+			}
 		} else {
-			got = 0;
 			if ( pfd[0].revents ) {
 				if ( (pfd[0].revents & ~POLLIN) ) {
-					throw std::runtime_error( string(__func__) + " poll error on pipe read" );
+					throw std::runtime_error( string(__func__) + " poll error on command channel" );
 				}
-				if ( nfds > 1 && pfd[1].revents ) {
-					acq_.flushBuf();
+				if ( async_ ) {
+					// discard everything acquired with the old parameters
+					async_->flush();
+				} else if ( n > 1 && pfd[1].revents ) {
+					xport_->flush();
 				}
-				pipe_->waitCmd( &cmd );
-			} else if ( (nfds > 1) && pfd[1].revents ) {
+				// may be spurious (command already taken)
+				if ( cmdChnl_->tryGetCmd( &cmd ) ) {
+					xport_->setParams( cmd.scopeParams() );
+				}
+			} else if ( (n > 1) && pfd[1].revents ) {
 				if ( (pfd[1].revents & ~POLLIN) ) {
 					throw std::runtime_error( string(__func__) + " poll error on IRQ read" );
 				}
-				got = readBuf_->read( &hdr, buf );
+				StageTimer tim( timing_, Stage::READ );
+				if ( async_ ) {
+					AcqCompletion c;
+					while ( (c = async_->tryPop()) ) {
+						deliver( &c.buf, &cmd, c.hdr, c.nbytes );
+					}
+				} else {
+					got = xport_->read( &hdr, buf->getRawData(), buf->getRawSize() );
+				}
 			}
 		}
+		readBusy_--;
 
 		if ( got > 0 ) {
-			unsigned nelms = got / bytesPerSmpl_;
-			// initHdr must be called first (sets nelms_)
-			buf->initHdr( &cmd, hdr, nelms );
-			for ( int ch = 0; ch < bufPool_->NumChannels; ch++ ) {
-				readBuf_->copyCh( buf, ch );
-				fftw_execute_dft_r2c( fftwPlan_, buf->getData( ch ), buf->getFFT( ch ) );
-				buf->computeAbsFFT( ch );
-				buf->measure( ch );
-			}
-			postMbox( &buf );
+			deliver( &buf, &cmd, hdr, got );
 		}
 	}
+
+	if ( async_ ) {
+		async_->stop();
+	}
+
+	// terminate the DSP stage
+	{
+	std::lock_guard lg( mutx_ );
+	dspStop_.store( true );
+	mboxTaken_.notify_all();
+	}
+	buf.reset();
+	dspQueue_.pushTail( buf );
+	dspThread_.join();
 }
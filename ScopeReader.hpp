@@ -27,105 +27,153 @@
 #pragma once
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 #include <type_traits>
 
 #include <fftw3.h>
 
 #include <Scope.hpp>
+#include <BufPool.hpp>
+#include <WorkerPool.hpp>
 #include <QApplication>
 #include <QProgressDialog>
 #include <QThread>
 #include <AcqCtrl.hpp>
 #include <DataReadyEvent.hpp>
 #include <BoardRef.hpp>
+#include <DSPKernels.hpp>
+#include <ReadBuf.hpp>
+#include <AcqTransport.hpp>
+#include <SimTransport.hpp>
+#include <AsyncAcq.hpp>
+#include <ThreadRT.hpp>
+#include <StageTiming.hpp>
+#include <Persistence.hpp>
+#include <memory>
 
-class ReadBufIF {
-public:
-	// read into buffer
-	// returns 0 if there were no samples
-	virtual unsigned
-	read(uint16_t *hdr, BufPtr buf) = 0;
-
-	// copy internal buffer into ADC buffer
-	// (unfortunately QWT only supports samples in row-major
-	// order [independent curves tightly packed] whereas
-	// we receive the data in column-major order which makes
-	// copying unavoidable; also, QWT does not support short int...)
-	// copy a single channel; can be used to parallelize...
-	virtual void copyCh(BufPtr buf, unsigned ch) = 0;
-
-	virtual ~ReadBufIF() {}
-};
-
-// ReadBuf configures its internal buffer to the actual number of samples
-// which is assumed to never change!
-template <typename T>
-class ReadBuf : public ReadBufIF {
-private:
-	AcqCtrl *acq_;
-public:
-	ReadBuf(AcqCtrl *acq)
-	: acq_( acq )
-	{
-	}
-
-	virtual unsigned
-	read(uint16_t *hdr, BufPtr buf) override
-	{
-		return acq_->readBuf( hdr, buf->getRawData(), buf->getRawSize() );
-	}
-
-	virtual ~ReadBuf()
-	{
-	}
-
-	virtual void
-	copyCh(BufPtr buf, unsigned ch) override
-	{
-		// getData already checks validity of 'ch'
-		BufType::ElementType *dptr            = buf->getData( ch );
-		T                    *sptr            = reinterpret_cast<T*>( buf->getRawData() ) + ch;
-		unsigned              nelms           = buf->getNElms();
-		double                scaleCorrection;
-		double                postGainOffsetTick;
-		if ( ((nelms - 1)*BufPoolType::NumChannels + ch) * sizeof(T) >= buf->getRawSize() ) {
-			throw std::runtime_error("Internal error: buffer overrun");
-		}
-		scaleCorrection    = buf->getScaleCorrection(ch);
-		postGainOffsetTick = buf->scopeParams()->afeParams[ch].postGainOffsetTick;
-
-		while ( nelms > 0 ) {
-			*dptr = scaleCorrection*(static_cast< std::remove_reference<decltype(*dptr)>::type >( *sptr ) - postGainOffsetTick);
-			dptr++;
-			sptr += BufPoolType::NumChannels;
-			nelms--;
-		}
-	}
+// Snapshot of the pipeline counters; the stages are
+//   [transfer thread -> completions ->]
+//   read (ScopeReader thread) -> DSP queue -> DSP thread -> mailbox -> GUI
+struct ScopeReaderStats {
+	uint64_t    framesRead         {0}; // acquired by the read stage
+	uint64_t    bytesRead          {0};
+	uint64_t    framesProcessed    {0}; // completed by the DSP stage
+	uint64_t    framesDropped      {0}; // evicted from a full DSP queue
+	uint64_t    framesStale        {0}; // discarded by the DSP stage (sync superseded)
+	unsigned    dspQueueFill       {0}; // current occupancy of the DSP queue
+	unsigned    dspQueueHighWater  {0};
+	unsigned    dspQueueDepth      {0};
+	unsigned    readBusy           {0}; // frames currently being read
+	unsigned    dspBusy            {0}; // frames currently being processed
+	unsigned    mboxFull           {0}; // frames waiting for the GUI
+	uint64_t    mboxPosted         {0}; // DataReadyEvents posted
+	uint64_t    mboxCoalesced      {0}; // frames replaced before the GUI took them
+	uint64_t    mboxConsumed       {0}; // frames taken by the GUI
+	// asynchronous acquisition only
+	uint64_t    acqTransfers       {0}; // frames transferred
+	uint64_t    acqDropped         {0}; // completions the read stage did not pick up in time
+	uint64_t    acqFlushed         {0}; // completions discarded due to new parameters
+	uint64_t    acqPoolEmpty       {0}; // transfer thread found no free buffer
+	unsigned    acqFill            {0}; // completions pending
+	uint64_t    framesNoBuf        {0}; // read stage found no buffer (synchronous reads)
+	ADCBufPoolStats pool;
 };
 
 class ScopeReader : public QThread {
 	AcqCtrl                     acq_;
 	BufPoolPtr                  bufPool_;
-	ScopeReaderCmdPipePtr       pipe_;
+	ScopeReaderCmdChannelPtr    cmdChnl_;
+	std::unique_ptr<AcqTransport> xport_;
+	// asynchronous acquisition (optional)
+	std::unique_ptr<AsyncAcq>   async_;
+	unsigned                    asyncDepth_      {0};
 	ReadBufIF                  *readBuf_;
+	// DSP stage -> GUI
+	BufMailbox<BufPtr>          mbox_;
+	// signalled when the GUI empties the mailbox (lazy mode)
 	std::mutex                  mutx_;
-	BufPtr                      mbox_;
+	std::condition_variable     mboxTaken_;
 	QObject                    *notified_;
 	unsigned                    bytesPerSmpl_; // for all channels
+	// read stage hands buffers to the DSP stage
+	BufRing<BufPtr>             dspQueue_;
+	std::thread                 dspThread_;
+	// per-channel processing in the DSP stage
+	WorkerPool                  workers_;
+	// scheduling attributes of the reader/DSP threads
+	RTCfg                       rtCfg_;
+	// persistence display (optional; atomic_load/atomic_store)
+	PersistencePtr              persist_;
+	// spectrum history (optional; atomic_load/atomic_store)
+	WaterfallPtr                waterfall_;
+
+	std::atomic<uint64_t>       framesRead_      {0};
+	std::atomic<uint64_t>       bytesRead_       {0};
+	std::atomic<uint64_t>       framesProcessed_ {0};
+	std::atomic<uint64_t>       framesDropped_   {0};
+	std::atomic<uint64_t>       framesStale_     {0};
+	std::atomic<uint64_t>       mboxPosted_      {0};
+	std::atomic<uint64_t>       mboxCoalesced_   {0};
+	std::atomic<uint64_t>       mboxConsumed_    {0};
+	std::atomic<uint64_t>       framesNoBuf_     {0};
+	std::atomic<unsigned>       readBusy_        {0};
+	std::atomic<unsigned>       dspBusy_         {0};
+	std::atomic<bool>           fastLog_         {true};
+	std::atomic<bool>           lazyDSP_         {false};
+	std::atomic<bool>           dspStop_         {false};
+	// hot-path latencies (compiled out unless CONFIG_STAGE_TIMING)
+	StageTiming                 timing_;
+	std::atomic<uint64_t>       mboxPostNs_      {0};
 
 	// Note: this buffer is only used to create the plan but it is
 	// also remembered by the plan; NEVER use plain fftw_execute with
 	// this plan but use the 'new array' interface!
 
-	fftw_plan                   fftwPlan_ {nullptr};
+	BufType::FFTW::Plan         fftwPlan_ {nullptr};
+
+	// hand a filled buffer to the DSP stage; if the DSP stage
+	// is lagging then the oldest pending buffer is dropped.
+	void queueForDSP(BufPtr *buf);
+
+	// stamp a freshly read buffer and pass it on
+	void deliver(BufPtr *buf, ScopeReaderCmd *cmd, uint16_t hdr, unsigned nbytes);
+
+	// DSP stage
+	void dspLoop();
+	// block until the GUI has taken the last frame (or
+	// the DSP stage is stopped)
+	void waitMboxEmpty();
+	// returns false if processing was abandoned because
+	// the data are stale
+	bool process(BufPtr &buf);
+
+	// the GUI has sent new parameters since 'buf' was acquired
+	// and will discard it.
+	bool isStale(const BufPtr &buf) const
+	{
+		return buf->getSync() != cmdChnl_->getLastSync();
+	}
 
 public:
+	// number of buffers the read stage may have pending
+	// in front of the DSP stage.
+	constexpr static unsigned   DSP_QUEUE_DEPTH = 1;
+
+	// while the pool has no buffer for the read stage it
+	// re-tries after this interval
+	constexpr static int        NOBUF_RETRY_MS  = 10;
+
 	ScopeReader(
-		BoardInterface         *brd,
-		BufPoolPtr              bufPool,
-		ScopeReaderCmdPipePtr   pipe,
-		QObject                *notifed,
-		QObject                *parent = NULL
+		BoardInterface           *brd,
+		BufPoolPtr                bufPool,
+		ScopeReaderCmdChannelPtr  cmdChnl,
+		QObject                  *notifed,
+		// threads for per-channel DSP; 0 picks one per channel
+		// (limited by the hardware concurrency)
+		unsigned                  dspWorkers = 0,
+		QObject                  *parent = NULL
 	);
 
 	// creating FFTW plan can take some time; use separate method
@@ -136,20 +184,126 @@ public:
 
 	void run() override;
 
-	BufPtr getMbox()
+	ScopeReaderStats getStats();
+
+	// The following must be called before start():
+
+	// read synthetic frames at 'rateHz' instead of
+	// the device's (for testing and benchmarking)
+	void useLoopback(double rateHz);
+
+	// read frames of simulated signals at 'rateHz' (channels
+	// without a signal produce noise); the generator follows
+	// the acquisition parameters.
+	void useSimSource(double rateHz, const std::vector<SimSignal> &sigs, double adcClkHz);
+
+	// keep the next transfer ready in a separate thread which
+	// holds up to 'depth' completed frames; 0 reads synchronously
+	// from the reader thread. The buffer pool must provide
+	// 'depth + 1' additional buffers.
+	void setAsyncDepth(unsigned depth)
+	{
+		asyncDepth_ = depth;
+	}
+
+	unsigned getAsyncDepth() const
 	{
+		return asyncDepth_;
+	}
+
+	// scheduling policy/priority and CPU affinity of the reader
+	// (and transfer) thread and of the DSP threads; applied when
+	// the reader starts, must be set before start().
+	void setRTCfg(const RTCfg &cfg)
+	{
+		rtCfg_ = cfg;
+	}
+
+	// use the approximate (vectorized) logarithm when computing
+	// the FFT modulus; the error is below 1E-6dB.
+	void setFastLog(bool fast)
+	{
+		fastLog_.store( fast );
+	}
+
+	bool getFastLog() const
+	{
+		return fastLog_.load();
+	}
+
+	// in 'lazy' mode the DSP stage only processes a new frame
+	// once the GUI has consumed the previous one. Frames arriving
+	// in the meantime are dropped unprocessed (the newest is kept)
+	// so that CPU usage follows the display rate rather than the
+	// trigger rate.
+	void setLazyDSP(bool lazy)
+	{
+		lazyDSP_.store( lazy );
+		// release a waiting DSP stage
 		std::lock_guard lg( mutx_ );
-		BufPtr rv;
-		mbox_.swap( rv );
+		mboxTaken_.notify_all();
+	}
+
+	bool getLazyDSP() const
+	{
+		return lazyDSP_.load();
+	}
+
+	// accumulate the processed frames into 'p' (may be
+	// changed at any time; an empty pointer stops accumulation)
+	void setPersistence(PersistencePtr p)
+	{
+		std::atomic_store( &persist_, p );
+	}
+
+	// append the spectra to 'w' (may be changed at any time;
+	// an empty pointer stops recording). Spectra are only
+	// computed while the FFT is enabled.
+	void setWaterfall(WaterfallPtr w)
+	{
+		std::atomic_store( &waterfall_, w );
+	}
+
+	unsigned getNumDSPWorkers() const
+	{
+		return workers_.size();
+	}
+
+	// per-stage latency histograms; the GUI records its own
+	// stages here, too.
+	StageTiming &getTiming()
+	{
+		return timing_;
+	}
+
+	// returns an empty pointer if there is no new frame
+	BufPtr getMbox()
+	{
+		BufPtr rv = mbox_.take();
+		if ( rv ) {
+			mboxConsumed_++;
+			timing_.record( Stage::MBOX, mboxPostNs_.load( std::memory_order_relaxed ) );
+			std::lock_guard lg( mutx_ );
+			mboxTaken_.notify_all();
+		}
 		return rv;
 	}
 
+	// on return '*buf' holds a frame the GUI did not take (if any)
 	void postMbox(BufPtr *buf)
 	{
-		std::lock_guard lg( mutx_ );
-		mbox_.swap( *buf );
-		// according to docs posted events are deleted eventually
-		QCoreApplication::postEvent( notified_, new DataReadyEvent() );
+		if ( StageTiming::ENABLED ) {
+			mboxPostNs_.store( StageTiming::now(), std::memory_order_relaxed );
+		}
+		// only notify if the mailbox was empty; otherwise the
+		// event that is still pending picks up the new frame.
+		if ( mbox_.post( *buf ) ) {
+			mboxPosted_++;
+			// according to docs posted events are deleted eventually
+			QCoreApplication::postEvent( notified_, new DataReadyEvent() );
+		} else {
+			mboxCoalesced_++;
+		}
 	}
 
 	~ScopeReader();
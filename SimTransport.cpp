@@ -0,0 +1,276 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <SimTransport.hpp>
+#include <unistd.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <stdexcept>
+
+bool
+SimSignal::parse(const char *spec)
+{
+	const char *col = strchr( spec, ':' );
+	size_t      len = col ? (size_t)(col - spec) : strlen( spec );
+
+	if        ( 4 == len && 0 == strncmp( spec, "sine",   len ) ) {
+		shape = Shape::SINE;
+	} else if ( 6 == len && 0 == strncmp( spec, "square", len ) ) {
+		shape = Shape::SQUARE;
+	} else if ( 5 == len && 0 == strncmp( spec, "noise",  len ) ) {
+		shape = Shape::NOISE;
+	} else if ( 5 == len && 0 == strncmp( spec, "burst",  len ) ) {
+		shape = Shape::BURST;
+	} else {
+		return false;
+	}
+
+	double *vals[] = { &freqHz, &amplVolt, &offVolt };
+	for ( unsigned i = 0; col && i < sizeof(vals)/sizeof(vals[0]); ++i ) {
+		char *end;
+		*vals[i] = strtod( col + 1, &end );
+		if ( end == col + 1 || ( *end && ':' != *end ) ) {
+			return false;
+		}
+		col = *end ? end : nullptr;
+	}
+	return ! col && freqHz >= 0.0;
+}
+
+SimTransport::SimTransport(unsigned sampleSize, unsigned nch, double rateHz, const std::vector<SimSignal> &sigs, double adcClkHz)
+: smplSz_   ( sampleSize ),
+  nch_      ( nch        ),
+  adcClkHz_ ( adcClkHz   ),
+  sigs_     ( sigs       ),
+  sine_     ( SINE_TBL_SZ + 1 )
+{
+	if ( ( 1 != sampleSize && 2 != sampleSize ) || 0 == nch || ! (adcClkHz > 0.0) ) {
+		throw std::invalid_argument( __func__ );
+	}
+	// extra entry so that interpolation needs no wrap-around
+	for ( unsigned i = 0; i <= SINE_TBL_SZ; ++i ) {
+		sine_[i] = sin( 2.0*M_PI*(double)i/(double)SINE_TBL_SZ );
+	}
+	while ( sigs_.size() < nch_ ) {
+		SimSignal s;
+		s.shape    = SimSignal::Shape::NOISE;
+		s.amplVolt = 0.01;
+		sigs_.push_back( s );
+	}
+	tfd_ = createRateTimer( rateHz );
+}
+
+SimTransport::~SimTransport()
+{
+	close( tfd_ );
+}
+
+void
+SimTransport::setParams(ScopeParamsCPtr params)
+{
+	std::lock_guard lg( mtx_ );
+	params_ = params;
+}
+
+void
+SimTransport::flush()
+{
+	readRateTimer( tfd_ );
+}
+
+// approximately gaussian with unit variance
+float
+SimTransport::noise()
+{
+	float sum = 0.0f;
+	for ( int i = 0; i < 4; ++i ) {
+		// xorshift32
+		rnd_ ^= rnd_ << 13;
+		rnd_ ^= rnd_ >> 17;
+		rnd_ ^= rnd_ << 5;
+		sum  += (float)rnd_ * (1.0f/4294967296.0f);
+	}
+	return ( sum - 2.0f ) * 1.7320508f;
+}
+
+float
+SimTransport::sample(const SimSignal &s, double phase)
+{
+	double   cyc = floor( phase );
+	double   frc = phase - cyc;
+	// linear interpolation; the error (< 4E-7 of the amplitude) is well
+	// below one LSB
+	double   idx = frc * SINE_TBL_SZ;
+	unsigned i   = (unsigned)idx;
+	if ( i >= SINE_TBL_SZ ) {
+		// frc rounded up to 1.0
+		i = SINE_TBL_SZ - 1;
+	}
+	float    sn  = sine_[i] + (float)( idx - (double)i ) * ( sine_[i + 1] - sine_[i] );
+	float    v;
+	switch ( s.shape ) {
+		case SimSignal::Shape::SINE:
+			v = s.amplVolt * sn;
+			break;
+		case SimSignal::Shape::SQUARE:
+			v = frc < 0.5 ? s.amplVolt : -s.amplVolt;
+			break;
+		case SimSignal::Shape::BURST:
+			v = fmod( cyc, SimSignal::BURST_PERIOD ) < SimSignal::BURST_ON ? s.amplVolt * sn : 0.0f;
+			break;
+		default:
+			v = s.amplVolt * noise();
+			break;
+	}
+	return s.offVolt + v;
+}
+
+template <typename T>
+void
+SimTransport::fill(T *dst, unsigned nelms, double t0, unsigned trgCh, int trgOff, const ScopeParams *p, double fs)
+{
+	double maxTick = (double)( (1U << (8*sizeof(T) - 1)) - 1 );
+	for ( unsigned ch = 0; ch < nch_; ++ch ) {
+		const SimSignal &s    = sigs_[ch];
+		double           fsv  = 1.0;
+		double           off  = 0.0;
+		if ( p && ch < p->numChannels ) {
+			if ( p->afeParams[ch].fullScaleVolt > 0.0 ) {
+				fsv = p->afeParams[ch].fullScaleVolt;
+			}
+			off = p->afeParams[ch].postGainOffsetTick;
+		}
+		double           scl  = maxTick/fsv;
+		double           inc  = s.freqHz/fs;
+		double           ph   = t0 * inc;
+		// phase in cycles; wrap to preserve precision
+		ph -= floor( ph );
+		T               *dp   = dst + ch;
+		for ( unsigned i = 0; i < nelms; ++i, dp += nch_ ) {
+			// the trigger channel is re-used so that noise matches
+			double v = ( ch == trgCh && trgOff >= 0 ) ? trg_[ trgOff + i ] : sample( s, ph + (double)i*inc );
+			v = v*scl + off;
+			if ( v > maxTick ) {
+				v = maxTick;
+			} else if ( v < -maxTick - 1.0 ) {
+				v = -maxTick - 1.0;
+			}
+			*dp = static_cast<T>( lrint( v ) );
+		}
+	}
+}
+
+unsigned
+SimTransport::read(uint16_t *hdr, uint8_t *dst, size_t size)
+{
+	uint64_t exp = readRateTimer( tfd_ );
+	if ( 0 == exp ) {
+		// no frame ready
+		return 0;
+	}
+
+	ScopeParamsCPtr params;
+	{
+	std::lock_guard lg( mtx_ );
+	params = params_;
+	}
+	const ScopeParams *p = params ? params.get() : nullptr;
+
+	// the configured record length (limited by the buffer size)
+	unsigned nelms = size / (nch_ * smplSz_);
+	if ( p && p->acqParams.nsamples > 0 && p->acqParams.nsamples < nelms ) {
+		nelms = p->acqParams.nsamples;
+	}
+	if ( 0 == nelms ) {
+		return 0;
+	}
+	double   fs    = adcClkHz_;
+	if ( p ) {
+		unsigned dec = p->acqParams.cic0Decimation * p->acqParams.cic1Decimation;
+		if ( dec > 1 ) {
+			fs /= (double)dec;
+		}
+	}
+
+	// frames are taken at arbitrary points in time
+	noise();
+	t_ += (double)nelms + (double)( rnd_ & 0xffff );
+	if ( t_ > 1.0E12 ) {
+		t_ = 0.0;
+	}
+
+	unsigned trgCh = nch_;
+	if ( p ) {
+		switch ( p->acqParams.src ) {
+			case CHA: trgCh = 0; break;
+			case CHB: trgCh = 1; break;
+			default :            break;
+		}
+	}
+
+	double   t0     = t_;
+	int      trgOff = -1;
+	*hdr = 0;
+	if ( trgCh < nch_ ) {
+		const SimSignal &s    = sigs_[trgCh];
+		unsigned         npts = std::min( (unsigned)p->acqParams.npts, nelms - 1 );
+		double           fsv  = trgCh < p->numChannels && p->afeParams[trgCh].fullScaleVolt > 0.0 ? p->afeParams[trgCh].fullScaleVolt : 1.0;
+		float            lvl  = acq_level_to_percent( p->acqParams.level )/100.0 * fsv;
+		bool             rise = p->acqParams.rising;
+		double           inc  = s.freqHz/fs;
+		double           ph   = t0 * inc;
+		ph -= floor( ph );
+		// search one frame length for the trigger; keep another
+		// frame worth of samples so the frame can be taken from here
+		trg_.resize( 2*nelms + npts );
+		for ( unsigned i = 0; i < trg_.size(); ++i ) {
+			trg_[i] = sample( s, ph + (double)i*inc );
+		}
+		for ( unsigned i = std::max( npts, 1U ); i < nelms + npts; ++i ) {
+			bool hit = rise ? ( trg_[i - 1] <  lvl && trg_[i] >= lvl )
+			                : ( trg_[i - 1] >  lvl && trg_[i] <= lvl );
+			if ( hit ) {
+				trgOff = i - npts;
+				break;
+			}
+		}
+		if ( trgOff < 0 ) {
+			// no edge: emulate the auto-trigger
+			trgOff = 0;
+			*hdr   = FW_BUF_HDR_FLG_AUTO_TRIGGERED;
+		}
+		t0 += trgOff;
+	}
+
+	if ( 2 == smplSz_ ) {
+		fill( reinterpret_cast<int16_t*>( dst ), nelms, t0, trgCh, trgOff, p, fs );
+	} else {
+		fill( reinterpret_cast<int8_t*> ( dst ), nelms, t0, trgCh, trgOff, p, fs );
+	}
+	return nelms * nch_ * smplSz_;
+}
@@ -0,0 +1,112 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+#include <AcqTransport.hpp>
+#include <ScopeParams.hpp>
+
+// Waveform of one simulated channel (in Volts at the ADC input)
+struct SimSignal {
+	enum class Shape { SINE, SQUARE, NOISE, BURST };
+
+	Shape   shape     { Shape::SINE };
+	double  freqHz    { 1.0E6       };
+	double  amplVolt  { 0.5         };
+	double  offVolt   { 0.0         };
+
+	// a BURST is a sine which is on during BURST_ON out of
+	// every BURST_PERIOD cycles
+	constexpr static unsigned BURST_PERIOD = 20;
+	constexpr static unsigned BURST_ON     =  5;
+
+	// "<sine|square|noise|burst>[:<freq_hz>[:<ampl_volt>[:<offset_volt>]]]";
+	// returns false on syntax errors.
+	bool parse(const char *spec);
+};
+
+// In-process signal generator standing in for the ADC: produces
+// frames of the configured waveforms at a fixed rate, honoring the
+// current record length, decimation, trigger source/edge/level,
+// number of pre-trigger samples and the channels' full-scale ranges.
+// If the trigger channel does not cross the level the frame is flagged
+// auto-triggered.
+// Only the data path is replaced; the acquisition parameters are
+// still read from (and programmed into) the Board, i.e., the device
+// or the simulated HDL app (-s).
+class SimTransport : public AcqTransport {
+private:
+	int                      tfd_;      // timerfd
+	unsigned                 smplSz_;   // bytes per sample
+	unsigned                 nch_;
+	double                   adcClkHz_;
+	std::vector<SimSignal>   sigs_;
+	std::mutex               mtx_;
+	ScopeParamsCPtr          params_;   // protected by mtx_
+	double                   t_       {0.0}; // sample clock of the next frame
+	uint32_t                 rnd_     {0x12345678};
+	std::vector<float>       trg_;      // trigger search
+	std::vector<float>       sine_;     // one period (plus one entry)
+
+	SimTransport(const SimTransport &)   = delete;
+
+	SimTransport &
+	operator=(const SimTransport &)      = delete;
+
+	float noise();
+	float sample(const SimSignal &s, double phase);
+
+	template <typename T>
+	void fill(T *dst, unsigned nelms, double t0, unsigned trgCh, int trgOff, const ScopeParams *p, double fs);
+
+public:
+	constexpr static unsigned SINE_TBL_SZ = 4096;
+
+	// 'sigs' lists the waveforms of channels 0, 1, ...; missing
+	// channels produce noise.
+	SimTransport(unsigned sampleSize, unsigned nch, double rateHz, const std::vector<SimSignal> &sigs, double adcClkHz);
+
+	virtual int
+	getReadyFD() override
+	{
+		return tfd_;
+	}
+
+	virtual void
+	setParams(ScopeParamsCPtr params) override;
+
+	virtual unsigned
+	read(uint16_t *hdr, uint8_t *dst, size_t size) override;
+
+	virtual void
+	flush() override;
+
+	virtual ~SimTransport();
+};
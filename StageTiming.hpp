@@ -0,0 +1,236 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+
+// Hot-path instrumentation: latency histograms of the individual
+// pipeline stages. Recording is only compiled in if CONFIG_STAGE_TIMING
+// is defined (cmake -DUSE_STAGE_TIMING=ON); otherwise all methods are
+// empty inlines and no storage is used.
+
+enum class Stage : unsigned {
+	POLL,      // read stage waiting for data
+	READ,      // transfer (or completion pickup) of a frame
+	COPY,      // de-interleaving and raw statistics (measurements)
+	LOD,       // min/max pyramids for drawing
+	PERSIST,   // persistence histograms (if enabled)
+	FFT,       // fftw_execute_dft_r2c (per channel)
+	ABS_FFT,   // computeAbsFFT (per channel)
+	MBOX,      // posted to the mailbox until taken by the GUI
+	GUI,       // Scope::display (newData and replot)
+	MEASURE,   // GUI: updating the measurement markers
+	NUM_STAGES
+};
+
+#ifdef CONFIG_STAGE_TIMING
+
+// Power-of-two histogram; may be updated concurrently from
+// multiple threads (relaxed atomics).
+class StageHisto {
+public:
+	// bin 'i' counts latencies in [2^i, 2^(i+1)) ns
+	constexpr static unsigned NUM_BINS = 36;
+
+	struct Snapshot {
+		uint64_t count             {0};
+		uint64_t sumNs             {0};
+		uint64_t maxNs             {0};
+		uint64_t bins[NUM_BINS]    {};
+
+		double
+		meanNs() const
+		{
+			return count ? (double)sumNs/(double)count : 0.0;
+		}
+
+		// upper bound of the bin holding the 'p' quantile (0 <= p <= 1)
+		double
+		quantileNs(double p) const
+		{
+			uint64_t lim = (uint64_t)( p * (double)count );
+			uint64_t acc = 0;
+			for ( unsigned i = 0; i < NUM_BINS; ++i ) {
+				if ( (acc += bins[i]) > lim ) {
+					return (double)( (uint64_t)2 << i );
+				}
+			}
+			return (double)maxNs;
+		}
+	};
+
+private:
+	std::atomic<uint64_t> count_ {0};
+	std::atomic<uint64_t> sum_   {0};
+	std::atomic<uint64_t> max_   {0};
+	std::atomic<uint64_t> bins_[NUM_BINS] {};
+
+public:
+	void
+	record(uint64_t ns)
+	{
+		unsigned b = ns ? 63 - __builtin_clzll( ns ) : 0;
+		if ( b >= NUM_BINS ) {
+			b = NUM_BINS - 1;
+		}
+		bins_[b].fetch_add( 1,  std::memory_order_relaxed );
+		count_  .fetch_add( 1,  std::memory_order_relaxed );
+		sum_    .fetch_add( ns, std::memory_order_relaxed );
+		uint64_t m = max_.load( std::memory_order_relaxed );
+		while ( ns > m && ! max_.compare_exchange_weak( m, ns, std::memory_order_relaxed ) )
+			;
+	}
+
+	Snapshot
+	snapshot() const
+	{
+		Snapshot s;
+		s.count = count_.load( std::memory_order_relaxed );
+		s.sumNs = sum_.load  ( std::memory_order_relaxed );
+		s.maxNs = max_.load  ( std::memory_order_relaxed );
+		for ( unsigned i = 0; i < NUM_BINS; ++i ) {
+			s.bins[i] = bins_[i].load( std::memory_order_relaxed );
+		}
+		return s;
+	}
+
+	void
+	reset()
+	{
+		for ( unsigned i = 0; i < NUM_BINS; ++i ) {
+			bins_[i].store( 0, std::memory_order_relaxed );
+		}
+		count_.store( 0, std::memory_order_relaxed );
+		sum_  .store( 0, std::memory_order_relaxed );
+		max_  .store( 0, std::memory_order_relaxed );
+	}
+};
+
+class StageTiming {
+	StageHisto histo_[ (unsigned)Stage::NUM_STAGES ];
+public:
+	constexpr static bool ENABLED = true;
+
+	// time stamp in ns (steady clock; a vDSO call on linux)
+	static uint64_t
+	now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	// record the time elapsed since 't0' (obtained from now())
+	void
+	record(Stage s, uint64_t t0)
+	{
+		histo_[ (unsigned)s ].record( now() - t0 );
+	}
+
+	StageHisto::Snapshot
+	snapshot(Stage s) const
+	{
+		return histo_[ (unsigned)s ].snapshot();
+	}
+
+	void
+	reset()
+	{
+		for ( auto &h : histo_ ) {
+			h.reset();
+		}
+	}
+
+	static const char *
+	name(Stage s)
+	{
+		static const char *nams[] = {
+			"poll", "read", "copy", "lod", "persist", "fft", "absFFT", "mailbox", "gui", "measure"
+		};
+		return nams[ (unsigned)s ];
+	}
+
+	// print all histograms
+	void
+	dump(FILE *f) const
+	{
+		for ( unsigned s = 0; s < (unsigned)Stage::NUM_STAGES; ++s ) {
+			StageHisto::Snapshot snap = histo_[s].snapshot();
+			fprintf( f, "# stage '%s': %llu samples, mean %.0fns, max %lluns\n",
+			         name( (Stage)s ), (unsigned long long)snap.count, snap.meanNs(), (unsigned long long)snap.maxNs );
+			for ( unsigned i = 0; i < StageHisto::NUM_BINS; ++i ) {
+				if ( snap.bins[i] ) {
+					fprintf( f, "%-8s %12llu %12llu\n", name( (Stage)s ), 1ULL << i, (unsigned long long)snap.bins[i] );
+				}
+			}
+		}
+	}
+};
+
+#else
+
+class StageTiming {
+public:
+	constexpr static bool ENABLED = false;
+
+	static uint64_t now()                  { return 0; }
+	void            record(Stage, uint64_t) {}
+	void            reset()                {}
+	void            dump(FILE *) const     {}
+};
+
+#endif
+
+// Record the lifetime of a scope as 'stage'
+class StageTimer {
+#ifdef CONFIG_STAGE_TIMING
+	StageTiming &timing_;
+	Stage        stage_;
+	uint64_t     t0_;
+public:
+	StageTimer(StageTiming &timing, Stage stage)
+	: timing_( timing              ),
+	  stage_ ( stage               ),
+	  t0_    ( StageTiming::now()  )
+	{
+	}
+
+	~StageTimer()
+	{
+		timing_.record( stage_, t0_ );
+	}
+#else
+public:
+	StageTimer(StageTiming &, Stage)
+	{
+	}
+#endif
+	StageTimer(const StageTimer &)            = delete;
+	StageTimer &operator=(const StageTimer &) = delete;
+};
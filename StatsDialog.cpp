@@ -0,0 +1,237 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <memory>
+#include <time.h>
+#include <stdio.h>
+
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include <StatsDialog.hpp>
+
+using std::unique_ptr;
+using std::string;
+
+static double
+monoTime()
+{
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (double)now.tv_sec + 1.0E-9*(double)now.tv_nsec;
+}
+
+StatsDialog::StatsDialog( ReaderGetter getReader, QWidget *parent )
+: QDialog    ( parent    ),
+  getReader_ ( getReader )
+{
+	setWindowTitle( "scope - Pipeline Statistics" );
+
+	auto buttonBox = unique_ptr<QDialogButtonBox>( new QDialogButtonBox( QDialogButtonBox::Close ) );
+	QObject::connect( buttonBox.get(), &QDialogButtonBox::rejected, this, &QDialog::reject );
+	if ( StageTiming::ENABLED ) {
+		auto rst = buttonBox->addButton( "Reset Histograms", QDialogButtonBox::ResetRole );
+		QObject::connect( rst, &QPushButton::clicked, this, &StatsDialog::resetTiming );
+	}
+	auto dmp = buttonBox->addButton( "Dump To File", QDialogButtonBox::ActionRole );
+	QObject::connect( dmp, &QPushButton::clicked, this, &StatsDialog::dumpToFile );
+
+	auto lay = unique_ptr<QVBoxLayout>( new QVBoxLayout() );
+	auto lbl = unique_ptr<QLabel>     ( new QLabel()      );
+	lbl->setFont( QFontDatabase::systemFont( QFontDatabase::FixedFont ) );
+	lbl->setTextInteractionFlags( Qt::TextSelectableByMouse );
+	lbl_     = lbl.get();
+	lay->addWidget( lbl.release() );
+	lay->addWidget( buttonBox.release() );
+	setLayout( lay.release() );
+
+	timer_ = new QTimer( this );
+	QObject::connect( timer_, &QTimer::timeout, this, &StatsDialog::refresh );
+}
+
+void
+StatsDialog::showEvent(QShowEvent *ev)
+{
+	QDialog::showEvent( ev );
+	refresh();
+	timer_->start( UPDATE_MS );
+}
+
+void
+StatsDialog::hideEvent(QHideEvent *ev)
+{
+	timer_->stop();
+	QDialog::hideEvent( ev );
+}
+
+string
+StatsDialog::format(ScopeReader *reader, const ScopeReaderStats &st, double fps, double mbps)
+{
+	string rv;
+	char   line[256];
+
+	snprintf( line, sizeof(line), "Throughput      : %10.1f frames/s %10.2f MB/s\n", fps, mbps );
+	rv += line;
+	snprintf( line, sizeof(line), "Frames read     : %10llu\n", (unsigned long long)st.framesRead );
+	rv += line;
+	snprintf( line, sizeof(line), "Frames processed: %10llu\n", (unsigned long long)st.framesProcessed );
+	rv += line;
+	snprintf( line, sizeof(line), "Dropped (queue) : %10llu\n", (unsigned long long)st.framesDropped );
+	rv += line;
+	snprintf( line, sizeof(line), "Stale           : %10llu\n", (unsigned long long)st.framesStale );
+	rv += line;
+	snprintf( line, sizeof(line), "No buffer       : %10llu\n", (unsigned long long)st.framesNoBuf );
+	rv += line;
+	snprintf( line, sizeof(line), "Mailbox         : %10llu posted %10llu coalesced %10llu taken\n",
+		(unsigned long long)st.mboxPosted,
+		(unsigned long long)st.mboxCoalesced,
+		(unsigned long long)st.mboxConsumed );
+	rv += line;
+	snprintf( line, sizeof(line), "DSP queue       : %10u fill   %10u high-water %10u depth\n",
+		st.dspQueueFill, st.dspQueueHighWater, st.dspQueueDepth );
+	rv += line;
+	snprintf( line, sizeof(line), "Buffer pool     : %10u bufs   %10u in use     %10u high-water\n",
+		st.pool.bufs, st.pool.inUse, st.pool.highWater );
+	rv += line;
+	snprintf( line, sizeof(line), "                  %10llu gets   %10llu exhausted  %10llu timeouts\n",
+		(unsigned long long)st.pool.gets,
+		(unsigned long long)st.pool.exhausted,
+		(unsigned long long)st.pool.timeouts );
+	rv += line;
+	snprintf( line, sizeof(line), "                  %10llu grown  %10llu reclaimed\n",
+		(unsigned long long)st.pool.grown,
+		(unsigned long long)st.pool.reclaimed );
+	rv += line;
+	if ( reader->getAsyncDepth() ) {
+		snprintf( line, sizeof(line),
+			"Async transfers : %10llu        %10llu dropped    %10llu flushed\n",
+			(unsigned long long)st.acqTransfers,
+			(unsigned long long)st.acqDropped,
+			(unsigned long long)st.acqFlushed );
+		rv += line;
+		snprintf( line, sizeof(line),
+			"                  %10llu no buffer\n",
+			(unsigned long long)st.acqPoolEmpty );
+		rv += line;
+	}
+
+#ifdef CONFIG_STAGE_TIMING
+	rv += "\nStage latencies [us]:\n";
+	snprintf( line, sizeof(line), "%-8s %12s %10s %10s %10s %10s\n", "stage", "count", "mean", "p50", "p99", "max" );
+	rv += line;
+	for ( unsigned s = 0; s < (unsigned)Stage::NUM_STAGES; ++s ) {
+		StageHisto::Snapshot snap = reader->getTiming().snapshot( (Stage)s );
+		snprintf( line, sizeof(line), "%-8s %12llu %10.1f %10.1f %10.1f %10.1f\n",
+			StageTiming::name( (Stage)s ),
+			(unsigned long long)snap.count,
+			snap.meanNs()           * 1.0E-3,
+			snap.quantileNs( 0.50 ) * 1.0E-3,
+			snap.quantileNs( 0.99 ) * 1.0E-3,
+			(double)snap.maxNs      * 1.0E-3 );
+		rv += line;
+	}
+	rv += "(quantiles are upper bounds of power-of-two bins)\n";
+#else
+	rv += "\nStage timing not compiled in (use cmake -DUSE_STAGE_TIMING=ON)\n";
+#endif
+	return rv;
+}
+
+void
+StatsDialog::refresh()
+{
+	ScopeReader *reader = getReader_();
+	if ( ! reader ) {
+		lbl_->setText( "Reader not running" );
+		return;
+	}
+	ScopeReaderStats st  = reader->getStats();
+	double           now = monoTime();
+	double           fps = 0.0, mbps = 0.0;
+	// the counters restart if the reader was replaced
+	if ( lastTime_ > 0.0 && st.framesRead >= last_.framesRead ) {
+		double dt = now - lastTime_;
+		fps  = (double)(st.framesRead - last_.framesRead)/dt;
+		mbps = (double)(st.bytesRead  - last_.bytesRead )/dt/1.0E6;
+	}
+	last_     = st;
+	lastTime_ = now;
+	lbl_->setText( QString::fromStdString( format( reader, st, fps, mbps ) ) );
+}
+
+void
+StatsDialog::resetTiming()
+{
+	ScopeReader *reader = getReader_();
+	if ( reader ) {
+		reader->getTiming().reset();
+	}
+}
+
+bool
+StatsDialog::dump(const char *fnam)
+{
+	ScopeReader *reader = getReader_();
+	if ( ! reader ) {
+		return false;
+	}
+	FILE *f = fopen( fnam, "w" );
+	if ( ! f ) {
+		return false;
+	}
+	// rates are from the last update
+	double fps  = 0.0, mbps = 0.0;
+	ScopeReaderStats st = reader->getStats();
+	if ( lastTime_ > 0.0 && st.framesRead >= last_.framesRead ) {
+		double dt = monoTime() - lastTime_;
+		if ( dt > 0.0 ) {
+			fps  = (double)(st.framesRead - last_.framesRead)/dt;
+			mbps = (double)(st.bytesRead  - last_.bytesRead )/dt/1.0E6;
+		}
+	}
+	fputs( format( reader, st, fps, mbps ).c_str(), f );
+	if ( StageTiming::ENABLED ) {
+		fprintf( f, "\n# per-stage histograms: stage, bin lower bound [ns], count\n" );
+		reader->getTiming().dump( f );
+	}
+	return 0 == fclose( f );
+}
+
+void
+StatsDialog::dumpToFile()
+{
+	string fileName = QFileDialog::getSaveFileName( this, "Dump Statistics", "scope_stats.txt", "(*.txt);; All Files (*)" ).toStdString();
+	if ( fileName.empty() ) {
+		return;
+	}
+	if ( ! dump( fileName.c_str() ) ) {
+		QMessageBox::warning( this, "Dump Statistics", QString( "Unable to write " ) + fileName.c_str() );
+	}
+}
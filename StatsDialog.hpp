@@ -0,0 +1,73 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <QDialog>
+#include <QLabel>
+#include <QTimer>
+
+#include <ScopeReader.hpp>
+
+// Live view of the pipeline counters, throughput and (if compiled
+// in) per-stage latency histograms. The reader may be replaced
+// (or be absent) while the dialog exists, hence it is obtained
+// through a callback on every update.
+class StatsDialog : public QDialog {
+public:
+	typedef std::function<ScopeReader *()> ReaderGetter;
+
+	constexpr static int UPDATE_MS = 1000;
+
+private:
+	ReaderGetter     getReader_;
+	QLabel          *lbl_;
+	QTimer          *timer_;
+	ScopeReaderStats last_;
+	double           lastTime_ {0.0};
+
+	void refresh();
+
+protected:
+	// refresh only while visible
+	void showEvent(QShowEvent *ev) override;
+	void hideEvent(QHideEvent *ev) override;
+
+public:
+	StatsDialog( ReaderGetter getReader, QWidget *parent );
+
+	// counters and latency summary in human-readable form
+	static std::string format(ScopeReader *reader, const ScopeReaderStats &st, double fps, double mbps);
+
+	// write the full statistics to a file; returns false on failure
+	bool dump(const char *fnam);
+
+	void resetTiming();
+	void dumpToFile();
+};
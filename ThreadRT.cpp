@@ -0,0 +1,257 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <ThreadRT.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <stdexcept>
+#include <string>
+
+#ifdef CONFIG_WITH_JANSSON
+#include <jansson.h>
+#endif
+
+static bool
+parsePolicy(const char *nam, size_t len, int *policy)
+{
+	if        ( 4 == len && 0 == strncmp( nam, "fifo",  len ) ) {
+		*policy = SCHED_FIFO;
+	} else if ( 2 == len && 0 == strncmp( nam, "rr",    len ) ) {
+		*policy = SCHED_RR;
+	} else if ( 5 == len && 0 == strncmp( nam, "other", len ) ) {
+		*policy = SCHED_OTHER;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// real-time policies reject priority 0
+static int
+defaultPriority(int policy)
+{
+	return SCHED_OTHER == policy ? 0 : sched_get_priority_min( policy );
+}
+
+static bool
+parseCpus(const char *s, std::vector<int> *cpus)
+{
+	cpus->clear();
+	while ( *s ) {
+		char *end;
+		long  from = strtol( s, &end, 0 );
+		long  to   = from;
+		if ( end == s || from < 0 ) {
+			return false;
+		}
+		if ( '-' == *end ) {
+			s  = end + 1;
+			to = strtol( s, &end, 0 );
+			if ( end == s || to < from ) {
+				return false;
+			}
+		}
+		while ( from <= to ) {
+			cpus->push_back( (int)from++ );
+		}
+		if ( ',' == *end ) {
+			end++;
+		} else if ( *end ) {
+			return false;
+		}
+		s = end;
+	}
+	return ! cpus->empty();
+}
+
+bool
+ThreadRTCfg::parse(const char *spec)
+{
+	const char *at  = strchr( spec, '@' );
+	const char *col = strchr( spec, ':' );
+	size_t      len;
+
+	if ( col && at && col > at ) {
+		return false;
+	}
+	len = col ? (size_t)(col - spec) : ( at ? (size_t)(at - spec) : strlen( spec ) );
+
+	policy   = SCHED_OTHER;
+	priority = 0;
+	cpus.clear();
+
+	if ( len > 0 && ! parsePolicy( spec, len, &policy ) ) {
+		return false;
+	}
+	priority = defaultPriority( policy );
+	if ( col ) {
+		char *end;
+		priority = (int)strtol( col + 1, &end, 0 );
+		if ( end == col + 1 || ( *end && end != at ) ) {
+			return false;
+		}
+	}
+	if ( at && ! parseCpus( at + 1, &cpus ) ) {
+		return false;
+	}
+	set = true;
+	return true;
+}
+
+#ifdef CONFIG_WITH_JANSSON
+static void
+loadThread(json_t *obj, const char *key, ThreadRTCfg *cfg)
+{
+	json_t *o = json_object_get( obj, key );
+	json_t *v;
+	if ( ! o ) {
+		return;
+	}
+	if ( ! json_is_object( o ) ) {
+		throw std::runtime_error( std::string( "RT config: '" ) + key + "' must be an object" );
+	}
+	cfg->policy   = SCHED_OTHER;
+	cfg->priority = 0;
+	cfg->cpus.clear();
+	if ( (v = json_object_get( o, "policy" )) ) {
+		const char *nam = json_string_value( v );
+		if ( ! nam || ! parsePolicy( nam, strlen( nam ), &cfg->policy ) ) {
+			throw std::runtime_error( std::string( "RT config: invalid policy for '" ) + key + "'" );
+		}
+	}
+	cfg->priority = defaultPriority( cfg->policy );
+	if ( (v = json_object_get( o, "priority" )) ) {
+		if ( ! json_is_integer( v ) ) {
+			throw std::runtime_error( std::string( "RT config: invalid priority for '" ) + key + "'" );
+		}
+		cfg->priority = (int)json_integer_value( v );
+	}
+	if ( (v = json_object_get( o, "cpus" )) ) {
+		size_t  i;
+		json_t *c;
+		if ( ! json_is_array( v ) ) {
+			throw std::runtime_error( std::string( "RT config: 'cpus' of '" ) + key + "' must be an array" );
+		}
+		json_array_foreach( v, i, c ) {
+			if ( ! json_is_integer( c ) || json_integer_value( c ) < 0 ) {
+				throw std::runtime_error( std::string( "RT config: invalid cpu for '" ) + key + "'" );
+			}
+			cfg->cpus.push_back( (int)json_integer_value( c ) );
+		}
+	}
+	cfg->set = true;
+}
+#endif
+
+void
+RTCfg::load(const char *fnam)
+{
+#ifdef CONFIG_WITH_JANSSON
+	json_error_t err;
+	json_t      *root = json_load_file( fnam, 0, &err );
+	if ( ! root ) {
+		throw std::runtime_error( std::string( "RT config: unable to load '" ) + fnam + "': " + err.text );
+	}
+	try {
+		json_t *v;
+		if ( ! json_is_object( root ) ) {
+			throw std::runtime_error( "RT config: expected a JSON object" );
+		}
+		loadThread( root, "reader", &reader );
+		loadThread( root, "dsp",    &dsp    );
+		if ( (v = json_object_get( root, "lockMemory" )) ) {
+			lockMemory = json_is_true( v );
+		}
+	} catch ( ... ) {
+		json_decref( root );
+		throw;
+	}
+	json_decref( root );
+#else
+	throw std::runtime_error( std::string( "RT config: JSON support not compiled in; cannot load '" ) + fnam + "'" );
+#endif
+}
+
+static void
+warn(const char *name, const char *what, int err)
+{
+	fprintf( stderr, "Warning: %s thread: unable to %s (%s)", name, what, strerror( err ) );
+	if ( EPERM == err ) {
+		fprintf( stderr, " - missing privileges (CAP_SYS_NICE or RLIMIT_RTPRIO)?" );
+	}
+	fprintf( stderr, "; continuing with default scheduling\n" );
+}
+
+bool
+applyThreadRT(pthread_t thread, const ThreadRTCfg &cfg, const char *name)
+{
+	bool ok = true;
+	int  st;
+
+	if ( ! cfg.set ) {
+		return true;
+	}
+
+	if ( ! cfg.cpus.empty() ) {
+		cpu_set_t set;
+		CPU_ZERO( &set );
+		for ( auto cpu : cfg.cpus ) {
+			if ( cpu < CPU_SETSIZE ) {
+				CPU_SET( cpu, &set );
+			}
+		}
+		if ( (st = pthread_setaffinity_np( thread, sizeof(set), &set )) ) {
+			warn( name, "set CPU affinity", st );
+			ok = false;
+		}
+	}
+
+	struct sched_param p;
+	p.sched_priority = ( SCHED_OTHER == cfg.policy ) ? 0 : cfg.priority;
+	if ( (st = pthread_setschedparam( thread, cfg.policy, &p )) ) {
+		warn( name, "set scheduling policy/priority", st );
+		ok = false;
+	}
+	return ok;
+}
+
+bool
+lockProcessMemory()
+{
+	if ( mlockall( MCL_CURRENT | MCL_FUTURE ) ) {
+		int err = errno;
+		fprintf( stderr, "Warning: unable to lock memory (%s)", strerror( err ) );
+		if ( EPERM == err || ENOMEM == err ) {
+			fprintf( stderr, " - missing privileges (CAP_IPC_LOCK or RLIMIT_MEMLOCK)?" );
+		}
+		fprintf( stderr, "; continuing\n" );
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,69 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <vector>
+
+// Scheduling attributes of a thread (or a group of threads)
+struct ThreadRTCfg {
+	int               policy   { SCHED_OTHER };
+	int               priority { 0 };
+	std::vector<int>  cpus;       // empty: do not pin
+	bool              set      { false };  // configured at all
+
+	// parse "<policy>[:<priority>][@<cpu_list>]"; policy is one of
+	// 'fifo', 'rr', 'other' (may be empty if a cpu_list is given),
+	// cpu_list e.g. "2,4-6". The priority of 'fifo' and 'rr'
+	// defaults to the policy's minimum. Returns false on syntax
+	// errors.
+	bool parse(const char *spec);
+};
+
+struct RTCfg {
+	ThreadRTCfg       reader;     // read stage (and transfer thread)
+	ThreadRTCfg       dsp;        // DSP stage and its workers
+	bool              lockMemory { false };
+
+	// load from a JSON file (same defaults as parse()), e.g.,
+	//   { "reader": { "policy": "fifo", "priority": 80, "cpus": [2] },
+	//     "dsp"   : { "policy": "rr",   "priority": 70, "cpus": [3, 4] },
+	//     "lockMemory": true }
+	// throws std::runtime_error on failure.
+	void load(const char *fnam);
+};
+
+// Apply 'cfg' to 'thread'; if this fails (usually due to missing
+// privileges) a warning is printed and the thread keeps running with
+// its current attributes. 'name' is used for the warning.
+// Returns false on failure.
+bool applyThreadRT(pthread_t thread, const ThreadRTCfg &cfg, const char *name);
+
+// Lock all current and future pages of the process; prints a
+// warning and returns false on failure.
+bool lockProcessMemory();
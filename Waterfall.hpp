@@ -0,0 +1,125 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+
+// Bounded history of spectra ("waterfall"). The DSP stage reduces
+// the FFT modulus of every frame to 'ncols' columns (the maximum of
+// the bins in each column so that narrow lines are not lost) and
+// stores it as a row in a ring of 'nrows'; the oldest row is over-
+// written. Readers fetch only the rows they have not seen yet
+// (tracked by a sequence number) so that the display can be updated
+// incrementally at constant cost per frame.
+// Rows of different channels may be pushed concurrently.
+template <typename T>
+class Waterfall {
+private:
+	struct Ring {
+		std::mutex         mtx;
+		std::vector<float> rows;
+		// number of rows pushed so far; the newest is at
+		// index (seq - 1) % nrows
+		uint64_t           seq {0};
+	};
+
+	unsigned                 nch_;
+	unsigned                 ncols_;
+	unsigned                 nrows_;
+	std::unique_ptr<Ring[]>  rings_;
+
+	Ring &
+	ring(unsigned ch)
+	{
+		if ( ch >= nch_ ) {
+			throw std::invalid_argument( "Waterfall: invalid channel" );
+		}
+		return rings_[ch];
+	}
+
+public:
+	Waterfall(unsigned nch, unsigned ncols, unsigned nrows)
+	: nch_   ( nch   ),
+	  ncols_ ( ncols ),
+	  nrows_ ( nrows ),
+	  rings_ ( new Ring[nch] )
+	{
+		if ( 0 == ncols || 0 == nrows ) {
+			throw std::invalid_argument( "Waterfall: invalid geometry" );
+		}
+		for ( unsigned ch = 0; ch < nch_; ++ch ) {
+			rings_[ch].rows.resize( (size_t)ncols_ * nrows_ );
+		}
+	}
+
+	unsigned getNumChannels() const { return nch_;   }
+	unsigned getCols()        const { return ncols_; }
+	unsigned getRows()        const { return nrows_; }
+
+	// add the spectrum 'm' ('n' bins) of channel 'ch'; column 'c'
+	// covers bins [c*n/ncols, (c+1)*n/ncols) (at least one).
+	void
+	push(unsigned ch, const T *m, size_t n)
+	{
+		if ( 0 == n ) {
+			return;
+		}
+		Ring &r = ring( ch );
+		std::lock_guard<std::mutex> lg( r.mtx );
+		float *row = &r.rows[ (size_t)( r.seq % nrows_ ) * ncols_ ];
+		for ( unsigned c = 0; c < ncols_; ++c ) {
+			size_t b0 = ( (uint64_t)c * n ) / ncols_;
+			size_t b1 = std::max( b0 + 1, (size_t)( ( (uint64_t)(c + 1) * n ) / ncols_ ) );
+			row[c]    = static_cast<float>( *std::max_element( m + b0, m + b1 ) );
+		}
+		r.seq++;
+	}
+
+	// copy the rows of channel 'ch' pushed since '*seq' (at most the
+	// whole ring; newest first) to 'dst' and advance '*seq'. Returns
+	// the number of rows copied.
+	unsigned
+	fetch(unsigned ch, uint64_t *seq, std::vector<float> *dst)
+	{
+		Ring &r = ring( ch );
+		std::lock_guard<std::mutex> lg( r.mtx );
+		uint64_t nnew = std::min( r.seq - std::min( *seq, r.seq ), (uint64_t)nrows_ );
+		dst->resize( nnew * ncols_ );
+		for ( uint64_t i = 0; i < nnew; ++i ) {
+			const float *row = &r.rows[ (size_t)( ( r.seq - 1 - i ) % nrows_ ) * ncols_ ];
+			std::copy( row, row + ncols_, dst->begin() + i * ncols_ );
+		}
+		*seq = r.seq;
+		return (unsigned)nnew;
+	}
+};
@@ -0,0 +1,159 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <WaterfallWidget.hpp>
+
+#include <QPainter>
+#include <algorithm>
+
+// black -> blue -> cyan -> yellow -> white
+static QRgb
+heat(double t)
+{
+	static const int knots[][3] = {
+		{   0,   0,   0 },
+		{   0,   0, 255 },
+		{   0, 255, 255 },
+		{ 255, 255,   0 },
+		{ 255, 255, 255 },
+	};
+	constexpr int nseg = sizeof(knots)/sizeof(knots[0]) - 1;
+	double   x = t * nseg;
+	int      s = std::min( (int)x, nseg - 1 );
+	double   f = x - s;
+	int      c[3];
+	for ( int i = 0; i < 3; ++i ) {
+		c[i] = (int)( knots[s][i] + f*( knots[s + 1][i] - knots[s][i] ) + 0.5 );
+	}
+	return qRgb( c[0], c[1], c[2] );
+}
+
+WaterfallWidget::WaterfallWidget(QWidget *parent)
+: QWidget( parent )
+{
+	for ( unsigned i = 0; i < LUT_SIZE; ++i ) {
+		lut_[i] = heat( (double)i/(double)(LUT_SIZE - 1) );
+	}
+	setAttribute( Qt::WA_OpaquePaintEvent );
+}
+
+QSize
+WaterfallWidget::sizeHint() const
+{
+	return QSize( 400, 200 );
+}
+
+void
+WaterfallWidget::setWaterfall(WaterfallPtr wf)
+{
+	wf_ = wf;
+	if ( wf_ ) {
+		img_ = QImage( wf_->getCols(), wf_->getRows(), QImage::Format_RGB32 );
+	} else {
+		img_ = QImage();
+	}
+	repaintAll();
+}
+
+void
+WaterfallWidget::setChannel(unsigned ch)
+{
+	if ( ch != ch_ ) {
+		ch_ = ch;
+		repaintAll();
+	}
+}
+
+void
+WaterfallWidget::setRange(double lo, double hi)
+{
+	if ( lo != lo_ || hi != hi_ ) {
+		lo_ = lo;
+		hi_ = hi;
+		repaintAll();
+	}
+}
+
+void
+WaterfallWidget::repaintAll()
+{
+	seq_ = 0;
+	top_ = 0;
+	if ( ! img_.isNull() ) {
+		img_.fill( lut_[0] );
+	}
+	refresh();
+}
+
+void
+WaterfallWidget::paintRows(unsigned n)
+{
+	unsigned ncols = img_.width();
+	unsigned nrows = img_.height();
+	double   scl   = hi_ > lo_ ? (double)(LUT_SIZE - 1)/(hi_ - lo_) : 0.0;
+	// 'rows_' holds the newest first
+	for ( unsigned i = n; i-- > 0; ) {
+		top_ = ( top_ + nrows - 1 ) % nrows;
+		const float *src = &rows_[ (size_t)i * ncols ];
+		QRgb        *dst = reinterpret_cast<QRgb*>( img_.scanLine( top_ ) );
+		for ( unsigned c = 0; c < ncols; ++c ) {
+			double v = ( src[c] - lo_ ) * scl;
+			dst[c]   = lut_[ (unsigned)std::min( std::max( v, 0.0 ), (double)(LUT_SIZE - 1) ) ];
+		}
+	}
+}
+
+void
+WaterfallWidget::refresh()
+{
+	if ( ! wf_ || ch_ >= wf_->getNumChannels() ) {
+		update();
+		return;
+	}
+	if ( unsigned n = wf_->fetch( ch_, &seq_, &rows_ ) ) {
+		paintRows( n );
+		update();
+	}
+}
+
+void
+WaterfallWidget::paintEvent(QPaintEvent *ev)
+{
+	QPainter p( this );
+	if ( img_.isNull() ) {
+		p.fillRect( rect(), lut_[0] );
+		return;
+	}
+	unsigned ncols = img_.width();
+	unsigned nrows = img_.height();
+	double   rh    = (double)height()/(double)nrows;
+	// rows [top_, nrows) are the newest, [0, top_) the oldest
+	double   h1    = ( nrows - top_ )*rh;
+	p.drawImage( QRectF( 0, 0,  width(), h1          ), img_, QRectF( 0, top_, ncols, nrows - top_ ) );
+	if ( top_ ) {
+		p.drawImage( QRectF( 0, h1, width(), height() - h1 ), img_, QRectF( 0, 0,    ncols, top_         ) );
+	}
+}
@@ -0,0 +1,82 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <vector>
+
+#include <QWidget>
+#include <QImage>
+#include <QColor>
+
+#include <BufTypes.hpp>
+
+// Waterfall display of the spectra of one channel; the newest
+// spectrum is at the top. The rows of the image form a ring: new
+// spectra are colored and written into the rows that held the
+// oldest ones and the image is drawn in two parts. Thus the cost
+// per frame is independent of the history length.
+// The colors cover the range [lo, hi] (log10 of the FFT modulus).
+class WaterfallWidget : public QWidget {
+public:
+	constexpr static unsigned LUT_SIZE = 256;
+
+private:
+	WaterfallPtr          wf_;
+	unsigned              ch_   {0};
+	// last row fetched from 'wf_'
+	uint64_t              seq_  {0};
+	QImage                img_;
+	// newest row of 'img_'
+	unsigned              top_  {0};
+	double                lo_   {0.0};
+	double                hi_   {1.0};
+	std::vector<float>    rows_;
+	QRgb                  lut_[LUT_SIZE];
+
+	// recolor the entire history
+	void repaintAll();
+
+	void paintRows(unsigned n);
+
+protected:
+	void paintEvent(QPaintEvent *ev) override;
+
+public:
+	WaterfallWidget(QWidget *parent = nullptr);
+
+	void setWaterfall(WaterfallPtr wf);
+
+	void setChannel(unsigned ch);
+
+	void setRange(double lo, double hi);
+
+	// pick up the spectra recorded since the last call
+	// and schedule a repaint
+	void refresh();
+
+	QSize sizeHint() const override;
+};
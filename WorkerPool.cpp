@@ -0,0 +1,110 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#include <WorkerPool.hpp>
+
+WorkerPool::WorkerPool(unsigned nthreads)
+{
+	if ( 0 == nthreads ) {
+		nthreads = std::thread::hardware_concurrency();
+	}
+	while ( nthreads-- > 1 ) {
+		threads_.push_back( std::thread( &WorkerPool::worker, this ) );
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+	std::lock_guard<std::mutex> g( mutx_ );
+	stop_ = true;
+	}
+	work_.notify_all();
+	for ( auto it = threads_.begin(); it != threads_.end(); ++it ) {
+		it->join();
+	}
+}
+
+void
+WorkerPool::drain(std::unique_lock<std::mutex> &g)
+{
+	while ( next_ < njobs_ ) {
+		unsigned idx = next_++;
+		g.unlock();
+		try {
+			job_( idx );
+		} catch ( ... ) {
+			g.lock();
+			if ( ! error_ ) {
+				error_ = std::current_exception();
+			}
+			g.unlock();
+		}
+		g.lock();
+		if ( 0 == --pending_ ) {
+			done_.notify_all();
+		}
+	}
+}
+
+void
+WorkerPool::worker()
+{
+	std::unique_lock<std::mutex> g( mutx_ );
+	while ( ! stop_ ) {
+		if ( next_ < njobs_ ) {
+			drain( g );
+		} else {
+			work_.wait( g );
+		}
+	}
+}
+
+void
+WorkerPool::run(unsigned njobs, const std::function<void(unsigned)> &job)
+{
+	std::exception_ptr err;
+	{
+	std::unique_lock<std::mutex> g( mutx_ );
+	job_     = job;
+	next_    = 0;
+	njobs_   = njobs;
+	pending_ = njobs;
+	error_   = nullptr;
+	if ( ! threads_.empty() ) {
+		work_.notify_all();
+	}
+	drain( g );
+	while ( pending_ > 0 ) {
+		done_.wait( g );
+	}
+	njobs_ = 0;
+	err.swap( error_ );
+	}
+	if ( err ) {
+		std::rethrow_exception( err );
+	}
+}
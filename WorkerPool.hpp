@@ -0,0 +1,85 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+// Fixed set of threads executing a batch of independent
+// jobs (e.g., one per channel). The thread calling run()
+// participates and run() returns when all jobs are done.
+class WorkerPool {
+	std::vector<std::thread>          threads_;
+	std::mutex                        mutx_;
+	std::condition_variable           work_;
+	std::condition_variable           done_;
+	std::function<void(unsigned)>     job_;
+	unsigned                          njobs_   {0};
+	unsigned                          next_    {0};
+	unsigned                          pending_ {0};
+	bool                              stop_    {false};
+	std::exception_ptr                error_;
+
+	WorkerPool(const WorkerPool &)    = delete;
+
+	WorkerPool &
+	operator=(const WorkerPool &)     = delete;
+
+	// execute jobs until none are left; must hold the lock
+	void drain(std::unique_lock<std::mutex> &g);
+
+	void worker();
+
+public:
+	// 'nthreads' includes the caller of run(), i.e., nthreads - 1
+	// threads are spawned; 0 picks std::thread::hardware_concurrency().
+	WorkerPool(unsigned nthreads = 0);
+
+	unsigned
+	size() const
+	{
+		return threads_.size() + 1;
+	}
+
+	// native handle of spawned thread 'i' (0 .. size() - 2), e.g.,
+	// for setting scheduling attributes
+	std::thread::native_handle_type
+	nativeHandle(unsigned i)
+	{
+		return threads_.at( i ).native_handle();
+	}
+
+	// execute job(0) .. job(njobs - 1) and wait for completion;
+	// the first exception thrown by a job is rethrown here.
+	void run(unsigned njobs, const std::function<void(unsigned)> &job);
+
+	~WorkerPool();
+};
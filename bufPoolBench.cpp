@@ -0,0 +1,180 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+// Contention micro-benchmark: mutex-based FreeList/BufFifo versus
+// their lock-free counterparts LFFreeList/LFBufFifo.
+
+#include <BufPool.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <string.h>
+#include <algorithm>
+
+// pool elements
+struct Elem {
+	uint64_t payload[8];
+};
+
+typedef std::shared_ptr<Elem> ElemPtr;
+
+// FIFO elements (BufFifo links them)
+struct Node : public BufNode<Node> {
+	uint64_t payload[8];
+};
+
+typedef std::shared_ptr<Node> NodePtr;
+
+typedef std::chrono::steady_clock Clock;
+
+static double
+elapsed(Clock::time_point then)
+{
+	return std::chrono::duration<double>( Clock::now() - then ).count();
+}
+
+// every thread repeatedly takes an element from the pool and
+// returns it; reports million get/put pairs per second
+template <typename Pool>
+static double
+benchPool(unsigned nthreads, unsigned niter)
+{
+	Pool pool( 0 );
+	// there are fewer elements than threads so the pool
+	// runs empty under contention
+	pool.add( nthreads > 1 ? nthreads/2 : 1 );
+
+	std::vector<std::thread> thrds;
+	auto                     then = Clock::now();
+	for ( unsigned t = 0; t < nthreads; ++t ) {
+		thrds.emplace_back( [&pool, niter]() {
+			unsigned i = 0;
+			while ( i < niter ) {
+				try {
+					ElemPtr e = pool.get();
+					e->payload[0]++;
+					i++;
+				} catch ( std::bad_alloc & ) {
+					std::this_thread::yield();
+				}
+			}
+		} );
+	}
+	for ( auto &t : thrds ) {
+		t.join();
+	}
+	return (double)nthreads*(double)niter/elapsed( then )/1.0E6;
+}
+
+// 'nthreads' producers pass elements through the FIFO to as many
+// consumers which return them through a second FIFO (an element must
+// only be on one BufFifo at a time); reports million elements per
+// second
+template <typename Fifo>
+static double
+benchFifo(unsigned nthreads, unsigned niter)
+{
+	Fifo                     fwd;
+	Fifo                     ret;
+	std::vector<std::thread> thrds;
+
+	for ( unsigned i = 0; i < std::min( 2*nthreads, 32U ); ++i ) {
+		ret.pushTail( std::make_shared<Node>() );
+	}
+
+	auto then = Clock::now();
+	for ( unsigned t = 0; t < nthreads; ++t ) {
+		thrds.emplace_back( [&fwd, &ret, niter]() {
+			for ( unsigned i = 0; i < niter; ++i ) {
+				fwd.pushTail( ret.popHead() );
+			}
+		} );
+		thrds.emplace_back( [&fwd, &ret, niter]() {
+			for ( unsigned i = 0; i < niter; ++i ) {
+				NodePtr n = fwd.popHead();
+				n->payload[0]++;
+				ret.pushTail( n );
+			}
+		} );
+	}
+	for ( auto &t : thrds ) {
+		t.join();
+	}
+	return (double)nthreads*(double)niter/elapsed( then )/1.0E6;
+}
+
+static void
+usage(const char *nm)
+{
+	printf("usage: %s [-h] [-t <max_threads>] [-n <iterations>]\n", nm);
+	printf("  -h              : Print this message.\n");
+	printf("  -t max_threads  : Run with 1, 2, 4, ... up to 'max_threads' threads\n");
+	printf("                    (defaults to the number of CPUs).\n");
+	printf("  -n iterations   : Operations per thread (defaults to 200000).\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned  maxThreads = std::thread::hardware_concurrency();
+	unsigned  niter      = 200000;
+	unsigned *u_p;
+	int       opt;
+
+	while ( (opt = getopt( argc, argv, "hn:t:" )) > 0 ) {
+		u_p = nullptr;
+		switch ( opt ) {
+			case 'h': usage( argv[0] ); return 0;
+			case 'n': u_p = &niter;      break;
+			case 't': u_p = &maxThreads; break;
+			default:
+				fprintf( stderr, "Unknown option -%c\n", opt );
+				usage( argv[0] );
+				return 1;
+		}
+		if ( u_p && 1 != sscanf( optarg, "%u", u_p ) ) {
+			fprintf( stderr, "Unable to scan option -%c arg\n", opt );
+			return 1;
+		}
+	}
+	if ( 0 == maxThreads ) {
+		maxThreads = 1;
+	}
+
+	printf("%8s %14s %14s %14s %14s\n", "threads", "FreeList", "LFFreeList", "BufFifo", "LFBufFifo");
+	printf("%8s %14s %14s %14s %14s\n", "",        "[Mops/s]", "[Mops/s]",   "[Mops/s]", "[Mops/s]" );
+	for ( unsigned n = 1; n <= maxThreads; n *= 2 ) {
+		printf("%8u %14.2f %14.2f %14.2f %14.2f\n", n,
+			benchPool< BufPool<Elem, FreeList>   >( n, niter ),
+			benchPool< BufPool<Elem, LFFreeList> >( n, niter ),
+			benchFifo< BufFifo<Node>             >( n, niter ),
+			benchFifo< LFBufFifo<Node>           >( n, niter ) );
+	}
+	return 0;
+}
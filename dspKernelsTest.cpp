@@ -0,0 +1,209 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+// Self-test of the DSPKernels: every vectorized implementation
+// supported by this CPU must de-interleave bit-identically to the
+// scalar code and the fast logModulus approximation must stay within
+// its documented error bound (1E-6dB) against libm.
+// Exits with a non-zero status if any check fails.
+
+#include <DSPKernels.hpp>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <array>
+#include <limits>
+
+using namespace DSPKernels;
+
+static const char *isaNames[] = { "scalar", "sse2", "avx2", "avx512" };
+
+// documented error bound of the fast logModulus (in dB)
+static const double LOGMOD_MAX_ERR_DB = 1.0E-6;
+
+static unsigned failures = 0;
+
+static void
+fail(const char *isa, const char *what)
+{
+	fprintf( stderr, "FAILED (%s): %s\n", isa, what );
+	failures++;
+}
+
+// pseudo-random raw samples covering the full range of 'T'
+template <typename T>
+static std::vector<T>
+mkRaw(size_t n, uint32_t seed)
+{
+	std::vector<T> v( n );
+	for ( size_t i = 0; i < n; ++i ) {
+		seed  = seed * 1664525 + 1013904223;
+		v[i]  = (T)( seed >> (32 - 8*sizeof(T)) );
+	}
+	return v;
+}
+
+static bool
+sameStats(const RawStats &a, const RawStats &b)
+{
+	return a.sum == b.sum && a.sumSq == b.sumSq && a.min == b.min && a.max == b.max;
+}
+
+// de-interleave with the current implementation; 'skip' channel (if
+// < nch) has a NULL destination.
+template <typename R, typename D>
+static void
+runDeint(const std::vector<R> &raw, unsigned nch, size_t nelms, unsigned skip, std::vector< std::vector<D> > *out, std::vector<RawStats> *stats)
+{
+	std::vector<D *>   dst( nch );
+	std::vector<double> scl( nch ), off( nch );
+	out->assign( nch, std::vector<D>( nelms ) );
+	stats->assign( nch, RawStats() );
+	for ( unsigned ch = 0; ch < nch; ++ch ) {
+		dst[ch] = ( ch == skip ? nullptr : (*out)[ch].data() );
+		scl[ch] = 1.0/(double)(ch + 3);
+		off[ch] = 0.25*(double)ch - 0.5;
+	}
+	deinterleave( raw.data(), nch, nelms, dst.data(), scl.data(), off.data(), stats->data() );
+}
+
+template <typename R, typename D>
+static void
+checkDeint(const char *isa, const char *what)
+{
+	// channel counts and lengths exercising vector bodies and tails
+	static const unsigned nchs[]   = { 1, 2, 3, 4, 5 };
+	static const size_t   nelmss[] = { 1, 7, 64, 1001 };
+
+	for ( auto nch : nchs ) {
+		for ( auto nelms : nelmss ) {
+			auto raw = mkRaw<R>( nch*nelms, 0xdeadbeef + nch );
+			for ( unsigned skip = 0; skip <= nch; skip += nch ) {
+				std::vector< std::vector<D> > ref, got;
+				std::vector<RawStats>         refStats, gotStats;
+
+				setISA( "scalar" );
+				runDeint( raw, nch, nelms, skip, &ref, &refStats );
+				setISA( isa );
+				runDeint( raw, nch, nelms, skip, &got, &gotStats );
+
+				for ( unsigned ch = 0; ch < nch; ++ch ) {
+					if ( 0 != memcmp( ref[ch].data(), got[ch].data(), nelms*sizeof(D) ) ) {
+						fail( isa, what );
+						fprintf( stderr, "  data mismatch (nch %u, nelms %zu, ch %u)\n", nch, nelms, ch );
+					}
+					if ( ! sameStats( refStats[ch], gotStats[ch] ) ) {
+						fail( isa, what );
+						fprintf( stderr, "  stats mismatch (nch %u, nelms %zu, ch %u)\n", nch, nelms, ch );
+					}
+				}
+			}
+		}
+	}
+}
+
+// complex numbers whose modulus spans the range of normal numbers
+// of 'D' (keeping re^2 + im^2 finite and normal)
+template <typename D>
+static std::vector< std::array<D, 2> >
+mkComplex(size_t n)
+{
+	std::vector< std::array<D, 2> > v( n );
+	int      emin = std::numeric_limits<D>::min_exponent/2 + 1;
+	int      emax = std::numeric_limits<D>::max_exponent/2 - 1;
+	uint32_t lfsr = 0x12345678;
+	for ( size_t i = 0; i < n; ++i ) {
+		lfsr = lfsr * 1664525 + 1013904223;
+		double m = 1.0 + (double)( lfsr >> 8 )/(double)(1U << 24);
+		int    e = emin + (int)( (uint64_t)i * (emax - emin) / n );
+		double a = 2.0*M_PI*(double)( lfsr & 0xff )/256.0;
+		v[i][0]  = (D)( ldexp( m, e ) * cos( a ) );
+		v[i][1]  = (D)( ldexp( m, e ) * sin( a ) );
+	}
+	return v;
+}
+
+template <typename D>
+static void
+checkLogMod(const char *isa, const char *what)
+{
+	const size_t n   = 10007;
+	auto         src = mkComplex<D>( n );
+	std::vector<D> dst( n );
+	// the result is stored as 'D'; allow for rounding it
+	double       tol = LOGMOD_MAX_ERR_DB;
+	double       err = 0.0;
+
+	setISA( isa );
+	logModulus( reinterpret_cast<const D (*)[2]>( src.data() ), n, dst.data(), true );
+	for ( size_t i = 0; i < n; ++i ) {
+		double re  = (double)src[i][0];
+		double im  = (double)src[i][1];
+		double ref = 0.5*log10( re*re + im*im );
+		double e   = 20.0*fabs( (double)dst[i] - ref );
+		double ulp = 20.0*0.5*(double)( nextafter( (D)ref, (D)INFINITY ) - (D)ref );
+		if ( e > err ) {
+			err = e;
+		}
+		if ( e > tol + ulp ) {
+			fail( isa, what );
+			fprintf( stderr, "  |src| = %g: error %g dB\n", hypot( re, im ), e );
+			return;
+		}
+	}
+	D zero[1][2] = { { 0, 0 } };
+	logModulus( zero, 1, dst.data(), true );
+	if ( dst[0] != -HUGE_VAL ) {
+		fail( isa, what );
+		fprintf( stderr, "  log of zero is %g\n", (double)dst[0] );
+	}
+	printf( "%-7s %-22s max. error %.3g dB\n", isa, what, err );
+}
+
+int
+main()
+{
+	for ( auto isa : isaNames ) {
+		if ( ! setISA( isa ) ) {
+			printf( "%-7s (not supported by this CPU; skipped)\n", isa );
+			continue;
+		}
+		checkDeint<int8_t,  double>( isa, "deinterleave int8/dbl" );
+		checkDeint<int16_t, double>( isa, "deinterleave int16/dbl" );
+		checkDeint<int8_t,  float >( isa, "deinterleave int8/flt" );
+		checkDeint<int16_t, float >( isa, "deinterleave int16/flt" );
+		checkLogMod<double>( isa, "logModulus (fast) dbl" );
+		checkLogMod<float >( isa, "logModulus (fast) flt" );
+	}
+	if ( failures ) {
+		fprintf( stderr, "%u check(s) FAILED\n", failures );
+		return 1;
+	}
+	printf( "all checks passed\n" );
+	return 0;
+}
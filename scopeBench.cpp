@@ -0,0 +1,332 @@
+/**LB-MIT
+ *
+ * MIT License
+ *
+ * Copyright (c) 2026 Till Straumann
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ **LE-MIT*/
+
+// Headless benchmark of the DSP chain the ScopeReader runs on every
+// frame (de-interleaving/scaling, raw statistics, min/max pyramid,
+// FFT, FFT modulus).
+// Synthetic interleaved raw frames are processed for a matrix of record
+// lengths, channel counts and raw sample sizes; no GUI or hardware is
+// involved. The FFT is planned with the same flags and wisdom file as
+// the ScopeReader.
+
+#include <BufTypes.hpp>
+#include <ReadBuf.hpp>
+#include <DSPKernels.hpp>
+#include <ScopeParams.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <getopt.h>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+typedef std::chrono::steady_clock Clock;
+
+static double
+elapsed(Clock::time_point then)
+{
+	return std::chrono::duration<double>( Clock::now() - then ).count();
+}
+
+// ScopeParams without a board: unit full-scale, no offsets
+class BenchParamsPool : public IntrusiveSmart::FreeListBase {
+public:
+	BenchParamsPool(unsigned nch)
+	{
+		size_t sz = sizeof(ScopeParamsPtr::element_type);
+		sz += nch * sizeof(static_cast<ScopeParams*>(nullptr)->afeParams[0]);
+		void *mem = operator new( sz, std::align_val_t( alignof( ScopeParamsPtr::element_type ) ) );
+		auto  p   = static_cast<ScopeParamsPtr::element_type *>(new(mem) IntrusiveSmart::FreeListNode);
+		memset( static_cast<ScopeParams*>( p ), 0, sz - sizeof(IntrusiveSmart::FreeListNode) );
+		p->numChannels = nch;
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			p->afeParams[ch].fullScaleVolt = 1.0;
+		}
+		p->acqParams.src            = CHA;
+		p->acqParams.cic0Decimation = 1;
+		p->acqParams.cic1Decimation = 1;
+		put( p );
+	}
+
+	ScopeParamsPtr
+	get()
+	{
+		auto rv = FreeListBase::get<typename ScopeParamsPtr::element_type>();
+		if ( ! rv ) {
+			throw std::bad_alloc();
+		}
+		return rv;
+	}
+};
+
+// interleaved sine (a different frequency per channel) plus a
+// little pseudo-random noise
+template <typename T>
+static void
+fillRaw(BufPtr buf, unsigned nelms, unsigned nch)
+{
+	T       *dp    = reinterpret_cast<T*>( buf->getRawData() );
+	double   ampl  = 0.8 * (double)( (1U << (8*sizeof(T) - 1)) - 1 );
+	uint32_t lfsr  = 0xdeadbeef;
+	for ( unsigned i = 0; i < nelms; ++i ) {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			lfsr   = lfsr * 1664525 + 1013904223;
+			*dp++  = (T)( ampl * sin( 2.0*M_PI*(double)((ch + 1)*i)/1024.0 ) + (double)( (int32_t)lfsr >> 29 ) );
+		}
+	}
+}
+
+struct StageResult {
+	const char *name;
+	double      secPerFrame;
+};
+
+// run 'fn' repeatedly for at least 'minSec' seconds; returns seconds/call
+static double
+timeStage(const std::function<void()> &fn, double minSec)
+{
+	// warm up caches and page tables
+	fn();
+	unsigned         n    = 0;
+	double           t;
+	Clock::time_point then = Clock::now();
+	do {
+		fn();
+		n++;
+	} while ( (t = elapsed( then )) < minSec );
+	return t/(double)n;
+}
+
+static std::vector<StageResult>
+benchConfig(unsigned nelms, unsigned nch, unsigned rawElSz, bool fast, double minSec)
+{
+	// buffers reference the parameters; must outlive them
+	BenchParamsPool params( nch );
+
+	auto pool = std::make_shared<BufPoolType>( nch, nelms, rawElSz );
+	pool->add( 1 );
+	BufPtr buf = pool->get();
+
+	AcqSettings cmd;
+	cmd.setScopeParams( params.get() );
+	buf->initHdr( &cmd, 0, nelms );
+
+	std::unique_ptr<ReadBufIF> readBuf;
+	if ( 2 == rawElSz ) {
+		fillRaw<int16_t>( buf, nelms, nch );
+		readBuf.reset( new ReadBuf<int16_t>() );
+	} else {
+		fillRaw<int8_t> ( buf, nelms, nch );
+		readBuf.reset( new ReadBuf<int8_t>() );
+	}
+
+	// same as ScopeReader::createFFTWPlan()
+	BufType::FFTW::Plan plan = BufType::FFTW::planR2C( buf->getMaxNElms(), buf->getData(0), buf->getFFT(0), FFTW_MEASURE | FFTW_PRESERVE_INPUT );
+	if ( ! plan ) {
+		throw std::runtime_error( "FFTW planning failed" );
+	}
+
+	std::vector<DSPKernels::RawStats> stats( nch );
+	std::vector<StageResult>          res;
+
+	res.push_back( { "copyCh", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			readBuf->copyCh( buf, ch );
+		}
+	}, minSec ) } );
+
+	res.push_back( { "copy", timeStage( [&]() {
+		readBuf->copy( buf, 0, nelms, &stats[0] );
+	}, minSec ) } );
+
+	res.push_back( { "measure", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			buf->setRawStats( ch, stats[ch] );
+			volatile double avg = buf->getAvg( ch );
+			volatile double sdv = buf->getStd( ch );
+			(void)avg; (void)sdv;
+		}
+	}, minSec ) } );
+
+	res.push_back( { "lod", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			buf->computeLOD( ch );
+		}
+	}, minSec ) } );
+
+	// geometry of the GUI (16-bit full scale)
+	PersistenceType pers( nch, std::min( 1024U, nelms ), 256, -32769.0, 32768.0, 0.95 );
+	res.push_back( { "persist", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			pers.accumulate( ch, buf->getData( ch ), nelms, 0 );
+		}
+	}, minSec ) } );
+
+	res.push_back( { "fft", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			BufType::FFTW::executeR2C( plan, buf->getData( ch ), buf->getFFT( ch ) );
+		}
+	}, minSec ) } );
+
+	res.push_back( { "absFFT", timeStage( [&]() {
+		for ( unsigned ch = 0; ch < nch; ++ch ) {
+			buf->computeAbsFFT( ch, fast );
+		}
+	}, minSec ) } );
+
+	BufType::FFTW::destroyPlan( plan );
+	return res;
+}
+
+static bool
+parseList(const char *arg, std::vector<unsigned> *l)
+{
+	l->clear();
+	while ( *arg ) {
+		char         *end;
+		unsigned long v = strtoul( arg, &end, 0 );
+		if ( end == arg || 0 == v ) {
+			return false;
+		}
+		switch ( toupper( *end ) ) {
+			case 'M': v *= 1024; /* fall through */
+			case 'K': v *= 1024; end++; break;
+			default : break;
+		}
+		l->push_back( (unsigned)v );
+		if ( ',' == *end ) {
+			end++;
+		} else if ( *end ) {
+			return false;
+		}
+		arg = end;
+	}
+	return ! l->empty();
+}
+
+static void
+usage(const char *nm)
+{
+	printf("usage: %s [-h] [-n <nsamples>] [-c <channels>] [-b <raw_bytes>] [-t <seconds>] [-x] [-W]\n", nm);
+	printf("  -h              : Print this message.\n");
+	printf("  -n nsamples     : Comma-separated list of record lengths; 'k' and 'M'\n");
+	printf("                    suffixes are accepted (defaults to 4k,64k,1M).\n");
+	printf("  -c channels     : Comma-separated list of channel counts (defaults\n");
+	printf("                    to 1,2,4; at most %u).\n", BufType::MAX_CHANNELS);
+	printf("  -b raw_bytes    : Comma-separated list of raw sample sizes, 1 (int8)\n");
+	printf("                    and/or 2 (int16) (defaults to 1,2).\n");
+	printf("  -t seconds      : Minimum run time per stage (defaults to 0.5).\n");
+	printf("  -x              : Use the exact (libm) logarithm in the FFT modulus.\n");
+	printf("  -W              : Neither read nor write the FFTW wisdom file\n");
+	printf("                    ('%s').\n", BufType::FFTW::WISDOM_FILE);
+}
+
+int
+main(int argc, char **argv)
+{
+	std::vector<unsigned> nsmpls { 4096, 65536, 1024*1024 };
+	std::vector<unsigned> nchs   { 1, 2, 4 };
+	std::vector<unsigned> rawSzs { 1, 2 };
+	double                minSec = 0.5;
+	bool                  fast   = true;
+	bool                  wisdom = true;
+	std::vector<unsigned> *l_p;
+	int                   opt;
+
+	while ( (opt = getopt( argc, argv, "b:c:hn:t:xW" )) > 0 ) {
+		l_p = nullptr;
+		switch ( opt ) {
+			case 'b': l_p = &rawSzs;     break;
+			case 'c': l_p = &nchs;       break;
+			case 'h': usage( argv[0] );  return 0;
+			case 'n': l_p = &nsmpls;     break;
+			case 't':
+				if ( 1 != sscanf( optarg, "%lg", &minSec ) ) {
+					fprintf( stderr, "Unable to scan option -%c arg\n", opt );
+					return 1;
+				}
+				break;
+			case 'x': fast   = false;    break;
+			case 'W': wisdom = false;    break;
+			default:
+				fprintf( stderr, "Unknown option -%c\n", opt );
+				usage( argv[0] );
+				return 1;
+		}
+		if ( l_p && ! parseList( optarg, l_p ) ) {
+			fprintf( stderr, "Unable to scan option -%c arg\n", opt );
+			return 1;
+		}
+	}
+	for ( auto nch : nchs ) {
+		if ( nch > BufType::MAX_CHANNELS ) {
+			fprintf( stderr, "Too many channels (%u)\n", nch );
+			return 1;
+		}
+	}
+	for ( auto sz : rawSzs ) {
+		if ( 1 != sz && 2 != sz ) {
+			fprintf( stderr, "Invalid raw sample size (%u)\n", sz );
+			return 1;
+		}
+	}
+
+	if ( wisdom ) {
+		BufType::FFTW::importWisdom( BufType::FFTW::WISDOM_FILE );
+	}
+
+	printf("'%s' kernels, %s samples, %s logarithm\n", DSPKernels::getISA(), sizeof(SampleType) == sizeof(float) ? "float" : "double", fast ? "fast" : "exact");
+	printf("%9s %3s %3s %-8s %12s %12s\n", "nsamples", "nch", "raw", "stage", "ns/sample", "frames/s");
+	for ( auto nelms : nsmpls ) {
+		for ( auto nch : nchs ) {
+			for ( auto sz : rawSzs ) {
+				double tot = 0.0;
+				// ns/sample refers to samples of all channels
+				double nsmpl = (double)nelms * (double)nch;
+				for ( auto &r : benchConfig( nelms, nch, sz, fast, minSec ) ) {
+					// 'copyCh' is the per-channel reference for 'copy'
+					if ( strcmp( r.name, "copyCh" ) ) {
+						tot += r.secPerFrame;
+					}
+					printf("%9u %3u %3u %-8s %12.3f %12.1f\n", nelms, nch, sz, r.name, r.secPerFrame*1.0E9/nsmpl, 1.0/r.secPerFrame);
+				}
+				printf("%9u %3u %3u %-8s %12.3f %12.1f\n", nelms, nch, sz, "total", tot*1.0E9/nsmpl, 1.0/tot);
+			}
+		}
+	}
+
+	if ( wisdom ) {
+		BufType::FFTW::exportWisdom( BufType::FFTW::WISDOM_FILE );
+	}
+	return 0;
+}